@@ -15,6 +15,9 @@
 #include <assert.h>
 #include <float.h>
 #include <time.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 extern char *optarg; // Added declaration for optarg
 
@@ -22,6 +25,7 @@ extern char *optarg; // Added declaration for optarg
 #include "memlib.h"
 #include "fsecs.h"
 #include "config.h"
+#include "tracez.h"
 
 /**********************
  * Constants and macros
@@ -31,6 +35,12 @@ extern char *optarg; // Added declaration for optarg
 #define MAXLINE 1024	   /* max string size */
 #define HDRLINES 4		   /* number of header lines in a trace file */
 #define LINENUM(i) (i + 5) /* cnvt trace request nums to linenums (origin 1) */
+#define MAX_PARSERS 64	   /* most threads that parse one text trace */
+#define MIN_CHUNK (1 << 20) /* smallest slice of a text trace worth a thread */
+
+/* isspace/isdigit for the C locale, without the table lookup */
+#define IS_SPACE(c) ((c) == ' ' || (unsigned)((c) - '\t') < 5)
+#define IS_DIGIT(c) ((unsigned)((c) - '0') < 10)
 
 /* Returns true if p is ALIGNMENT-byte aligned */
 #define IS_ALIGNED(p) ((((unsigned int)(p)) % ALIGNMENT) == 0)
@@ -47,24 +57,33 @@ typedef struct range_t
 	struct range_t *next; /* next list element */
 } range_t;
 
-/* Characterizes a single trace operation (allocator request) */
+/* Types of trace operations (allocator requests) */
+enum
+{
+	ALLOC,
+	FREE,
+	REALLOC
+};
+
+/*
+ * Characterizes a single trace operation, packed into 8 bytes so that a
+ * big trace streams through the cache at 8 ops per line. index is a
+ * dense slot number assigned by read_trace, not the id in the file.
+ */
 typedef struct
 {
-	enum
-	{
-		ALLOC,
-		FREE,
-		REALLOC
-	} type;	   /* type of request */
-	int index; /* index for free() to use later */
-	int size;  /* byte size of alloc/realloc request */
+	unsigned type : 2;	   /* type of request */
+	unsigned index : 30;   /* slot in blocks[] for free() to use later */
+	unsigned size;		   /* byte size of alloc/realloc request */
 } traceop_t;
 
+#define MAX_TRACE_SLOTS (1u << 30)
+
 /* Holds the information for one trace file*/
 typedef struct
 {
 	int sugg_heapsize;	 /* suggested heap size (unused) */
-	int num_ids;		 /* number of alloc/realloc ids */
+	int num_ids;		 /* number of blocks[] slots (peak live ids) */
 	int num_ops;		 /* number of distinct requests */
 	int weight;			 /* weight for this trace (unused) */
 	traceop_t *ops;		 /* array of requests */
@@ -97,10 +116,43 @@ typedef struct
 	/* Note: secs and util are only defined if valid is true */
 } stats_t;
 
+/* Where the bytes of the heap went at the trace's peak (-F) */
+typedef struct
+{
+	mm_frag_t frag;	   /* breakdown of the heap at the peak */
+	size_t peak_heap;  /* heap size at the peak */
+	size_t final_heap; /* heap size after the whole trace (util's denominator) */
+} frag_stats_t;
+
+/* Realloc traffic and how much of it fit in the old block's slack (-U) */
+typedef struct
+{
+	long reallocs;	/* mm_realloc calls */
+	long grows;		/* calls that asked for more than the previous request */
+	long in_slack;	/* grows that fit in mm_usable_size of the old block */
+	long moves;		/* calls that returned a different block */
+	double copied;	/* payload bytes the moves had to carry over */
+} realloc_stats_t;
+
+/* One slice of a mapped text trace and the ops parsed from it */
+typedef struct
+{
+	const char *lo, *hi;  /* whole lines [lo, hi) */
+	traceop_t *ops;		  /* ops parsed from the slice, in order */
+	unsigned nops, cap;	  /* ops parsed, room in ops[] */
+	unsigned limit;		  /* header's op count; ops[] never grows past it */
+	int fixed;			  /* ops[] is trace->ops and must not be realloc'd */
+	unsigned max_index;	  /* largest alloc/realloc id in the slice */
+	const char *bad;	  /* first request that did not parse, or NULL */
+	int overflow;		  /* the slice alone has more ops than the header */
+} chunk_t;
+
 /********************
  * Global variables
  *******************/
 int verbose = 0;	   /* global flag for verbose output */
+static int check_budget = 0; /* blocks mm_checkheap examines per op (-c) */
+static int parse_threads = 0; /* threads parsing a text trace, 0 = one per CPU (-j) */
 static int errors = 0; /* number of errs found when running student malloc */
 char msg[MAXLINE];	   /* for whenever we need to compose an error message */
 
@@ -124,6 +176,14 @@ static void clear_ranges(range_t **ranges);
 /* These functions read, allocate, and free storage for traces */
 static trace_t *read_trace(char *tracedir, char *filename);
 static void free_trace(trace_t *trace);
+static void renumber_ids(trace_t *trace);
+static const char *map_trace(FILE *tracefile, char *path, trace_t *trace,
+							 char **map, size_t *map_len);
+static unsigned read_ops_text(const char *body, const char *end,
+							  trace_t *trace, char *path, unsigned *max_index);
+static void *parse_chunk(void *arg);
+static unsigned read_ops_z(tz_reader_t *tz, trace_t *trace, char *path,
+						   unsigned *max_index);
 
 /* Routines for evaluating the correctness and speed of libc malloc */
 static int eval_libc_valid(trace_t *trace, int tracenum);
@@ -133,10 +193,21 @@ static void eval_libc_speed(void *ptr);
    of the student's malloc package in mm.c */
 static int eval_mm_valid(trace_t *trace, int tracenum, range_t **ranges);
 static double eval_mm_util(trace_t *trace, int tracenum, range_t **ranges);
+static void eval_mm_frag(trace_t *trace, frag_stats_t *fs);
+static void eval_mm_realloc(trace_t *trace, realloc_stats_t *rs);
 static void eval_mm_speed(void *ptr);
 
+/* Reference backends that calibrate the replay loop (-R) */
+static void eval_null_speed(void *ptr);
+static void eval_bump_speed(void *ptr);
+
 /* Various helper routines */
 static void printresults(int n, stats_t *stats);
+static void printfrag(int n, stats_t *stats, frag_stats_t *frags);
+static void printrealloc(int n, stats_t *stats, realloc_stats_t *reallocs);
+static void printsplit(int n, stats_t *stats, double *base_util);
+static void printcalib(int n, stats_t *stats, stats_t *null_stats,
+					   stats_t *bump_stats);
 static void usage(void);
 static void unix_error(char *msg);
 static void malloc_error(int tracenum, int opnum, char *msg);
@@ -162,6 +233,19 @@ int main(int argc, char **argv)
 	int team_check = 1; /* If set, check team structure (reset by -a) */
 	int run_libc = 0;	/* If set, run libc malloc (set by -l) */
 	int autograder = 0; /* If set, emit summary info for autograder (-g) */
+	size_t sample_interval = 0; /* If set, sample the mm heap every n bytes (-s) */
+	int frag_report = 0; /* If set, break down the waste at each trace's peak (-F) */
+	size_t nursery_chunk = 0; /* If set, nursery chunk size in bytes (-N) */
+	size_t align_lo = 0; /* If set, line-align payloads of this many bytes and up (-L) */
+	int reorder_budget = 0; /* If set, free-list nodes reordered per heap growth (-O) */
+	size_t split_high = 0; /* If set, blocks this large are placed from the high end (-T) */
+	double *base_util = NULL; /* util of each trace with one-ended placement (-T) */
+	frag_stats_t *frags = NULL; /* fragmentation breakdown for each trace */
+	int realloc_report = 0; /* If set, report realloc calls the slack would absorb (-U) */
+	realloc_stats_t *reallocs = NULL; /* realloc traffic for each trace */
+	int calibrate = 0; /* If set, also time the null and bump backends (-R) */
+	stats_t *null_stats = NULL; /* replay loop with no-op allocator calls */
+	stats_t *bump_stats = NULL; /* replay loop with a pure bump allocator */
 
 	/* temporaries used to compute the performance index */
 	double secs, ops, util, avg_mm_util, avg_mm_throughput, p1, p2, perfindex;
@@ -170,7 +254,7 @@ int main(int argc, char **argv)
 	/*
 	 * Read and interpret the command line arguments
 	 */
-	while ((c = getopt(argc, argv, "f:t:hvVgal")) != EOF)
+	while ((c = getopt(argc, argv, "f:t:s:c:j:N:L:O:T:hvVgalFRU")) != EOF)
 	{
 		printf("getopt returned: %d\n", c); // 디버깅용 출력 추가
 
@@ -194,6 +278,36 @@ int main(int argc, char **argv)
 			if (tracedir[strlen(tracedir) - 1] != '/')
 				strcat(tracedir, "/"); /* path always ends with "/" */
 			break;
+		case 's': /* Sample mm_malloc every n bytes and print heap profiles */
+			sample_interval = strtoul(optarg, NULL, 0);
+			break;
+		case 'N': /* Bump-allocate small requests from nursery chunks */
+			nursery_chunk = strtoul(optarg, NULL, 0);
+			break;
+		case 'L': /* Place medium payloads on cache-line boundaries */
+			align_lo = strtoul(optarg, NULL, 0);
+			break;
+		case 'O': /* Reorder free lists by address a few nodes per heap growth */
+			reorder_budget = atoi(optarg);
+			break;
+		case 'T': /* Place large blocks from the high end of free blocks */
+			split_high = strtoul(optarg, NULL, 0);
+			break;
+		case 'F': /* Break down fragmentation at each trace's peak */
+			frag_report = 1;
+			break;
+		case 'R': /* Calibrate the replay loop with reference backends */
+			calibrate = 1;
+			break;
+		case 'U': /* Report realloc calls that fit in mm_usable_size */
+			realloc_report = 1;
+			break;
+		case 'c': /* Run the incremental heap checker during validation */
+			check_budget = atoi(optarg);
+			break;
+		case 'j': /* Threads that parse a text trace */
+			parse_threads = atoi(optarg);
+			break;
 		case 'a': /* Don't check team structure */
 			team_check = 0;
 			break;
@@ -309,9 +423,24 @@ int main(int argc, char **argv)
 	mm_stats = (stats_t *)calloc(num_tracefiles, sizeof(stats_t));
 	if (mm_stats == NULL)
 		unix_error("mm_stats calloc in main failed");
+	if (frag_report && (frags = (frag_stats_t *)calloc(num_tracefiles, sizeof(frag_stats_t))) == NULL)
+		unix_error("frags calloc in main failed");
+	if (realloc_report && (reallocs = (realloc_stats_t *)calloc(num_tracefiles, sizeof(realloc_stats_t))) == NULL)
+		unix_error("reallocs calloc in main failed");
+	if (split_high && (base_util = (double *)calloc(num_tracefiles, sizeof(double))) == NULL)
+		unix_error("base_util calloc in main failed");
+	if (calibrate &&
+		((null_stats = (stats_t *)calloc(num_tracefiles, sizeof(stats_t))) == NULL ||
+		 (bump_stats = (stats_t *)calloc(num_tracefiles, sizeof(stats_t))) == NULL))
+		unix_error("calibration stats calloc in main failed");
 
 	/* Initialize the simulated memory system in memlib.c */
 	mem_init();
+	mm_sample_set_interval(sample_interval);
+	mm_nursery_set(nursery_chunk);
+	mm_align_set(align_lo, 4096);
+	mm_reorder_set_budget(reorder_budget);
+	mm_split_set(split_high);
 
 	/* Evaluate student's mm malloc package using the K-best scheme */
 	for (i = 0; i < num_tracefiles; i++)
@@ -326,11 +455,32 @@ int main(int argc, char **argv)
 			if (verbose > 1)
 				printf("efficiency, ");
 			mm_stats[i].util = eval_mm_util(trace, i, &ranges);
+			if (split_high)
+			{
+				mm_split_set(0);
+				base_util[i] = eval_mm_util(trace, i, &ranges);
+				mm_split_set(split_high);
+			}
+			if (frag_report)
+				eval_mm_frag(trace, &frags[i]);
+			if (realloc_report)
+				eval_mm_realloc(trace, &reallocs[i]);
+			if (sample_interval)
+			{
+				printf("\n%s ", tracefiles[i]);
+				mm_sample_dump(stdout);
+			}
 			speed_params.trace = trace;
 			speed_params.ranges = ranges;
 			if (verbose > 1)
 				printf("and performance.\n");
 			mm_stats[i].secs = fsecs(eval_mm_speed, &speed_params);
+			if (calibrate)
+			{
+				null_stats[i] = bump_stats[i] = mm_stats[i];
+				null_stats[i].secs = fsecs(eval_null_speed, &speed_params);
+				bump_stats[i].secs = fsecs(eval_bump_speed, &speed_params);
+			}
 		}
 		free_trace(trace);
 	}
@@ -342,6 +492,30 @@ int main(int argc, char **argv)
 		printresults(num_tracefiles, mm_stats);
 		printf("\n");
 	}
+	if (frag_report)
+	{
+		printf("Fragmentation at peak (%% of final heap):\n");
+		printfrag(num_tracefiles, mm_stats, frags);
+		printf("\n");
+	}
+	if (split_high)
+	{
+		printf("Two-ended placement (blocks of %zu bytes and up from the high end):\n", split_high);
+		printsplit(num_tracefiles, mm_stats, base_util);
+		printf("\n");
+	}
+	if (realloc_report)
+	{
+		printf("Realloc traffic (slack = grows within mm_usable_size of the old block):\n");
+		printrealloc(num_tracefiles, mm_stats, reallocs);
+		printf("\n");
+	}
+	if (calibrate)
+	{
+		printf("Replay loop calibration (Kops; adj = loop time subtracted):\n");
+		printcalib(num_tracefiles, mm_stats, null_stats, bump_stats);
+		printf("\n");
+	}
 
 	/*
 	 * Accumulate the aggregate statistics for the student's mm package
@@ -514,11 +688,15 @@ static trace_t *read_trace(char *tracedir, char *filename)
 {
 	FILE *tracefile;
 	trace_t *trace;
-	char type[MAXLINE];
 	char path[MAXLINE];
-	unsigned index, size;
 	unsigned max_index = 0;
 	unsigned op_index;
+	tz_reader_t tz;		/* set if the file is a compressed container */
+	tz_header_t tzh;
+	int compressed;
+	char *map = NULL;	/* the mapped text trace... */
+	size_t map_len = 0;
+	const char *body = NULL; /* ... and its first request */
 
 	if (verbose > 1)
 		printf("Reading tracefile: %s\n", filename);
@@ -535,10 +713,15 @@ static trace_t *read_trace(char *tracedir, char *filename)
 		sprintf(msg, "Could not open %s in read_trace", path);
 		unix_error(msg);
 	}
-	fscanf(tracefile, "%d", &(trace->sugg_heapsize)); /* not used */
-	fscanf(tracefile, "%d", &(trace->num_ids));
-	fscanf(tracefile, "%d", &(trace->num_ops));
-	fscanf(tracefile, "%d", &(trace->weight)); /* not used */
+	if ((compressed = (tz_open(&tz, tracefile, &tzh) == 0)))
+	{
+		trace->sugg_heapsize = tzh.sugg_heapsize;
+		trace->num_ids = tzh.num_ids;
+		trace->num_ops = tzh.num_ops;
+		trace->weight = tzh.weight;
+	}
+	else
+		body = map_trace(tracefile, path, trace, &map, &map_len);
 
 	/* We'll store each request line in the trace in this array */
 	if ((trace->ops =
@@ -556,43 +739,341 @@ static trace_t *read_trace(char *tracedir, char *filename)
 		unix_error("malloc 4 failed in read_trace");
 
 	/* read every request line in the trace file */
-	index = 0;
+	if (compressed)
+		op_index = read_ops_z(&tz, trace, path, &max_index);
+	else
+	{
+		op_index = read_ops_text(body, map + map_len, trace, path, &max_index);
+		munmap(map, map_len);
+	}
+	fclose(tracefile);
+	assert(max_index == trace->num_ids - 1);
+	assert(trace->num_ops == op_index);
+	renumber_ids(trace);
+
+	return trace;
+}
+
+/*
+ * map_trace - Map a text trace and read its four header lines into
+ *     trace. Returns the first byte after the header; the mapping is
+ *     returned through map and map_len for read_trace to unmap.
+ */
+static const char *map_trace(FILE *tracefile, char *path, trace_t *trace,
+							 char **map, size_t *map_len)
+{
+	struct stat st;
+	int *fields[] = {&trace->sugg_heapsize, &trace->num_ids,
+					 &trace->num_ops, &trace->weight};
+	const char *p, *end;
+	int i;
+
+	if (fstat(fileno(tracefile), &st) < 0)
+	{
+		sprintf(msg, "Could not stat %s in read_trace", path);
+		unix_error(msg);
+	}
+	*map_len = st.st_size;
+	*map = *map_len ? mmap(NULL, *map_len, PROT_READ, MAP_PRIVATE | MAP_POPULATE,
+						   fileno(tracefile), 0) : MAP_FAILED;
+	if (*map == MAP_FAILED)
+	{
+		printf("Missing header in tracefile %s\n", path);
+		exit(1);
+	}
+	madvise(*map, *map_len, MADV_SEQUENTIAL);
+
+	p = *map;
+	end = *map + *map_len;
+	for (i = 0; i < HDRLINES; i++)
+	{
+		unsigned v = 0;
+		while (p < end && IS_SPACE(*p))
+			p++;
+		if (p == end || !IS_DIGIT(*p))
+		{
+			printf("Missing header in tracefile %s\n", path);
+			exit(1);
+		}
+		while (p < end && IS_DIGIT(*p))
+			v = v * 10 + (*p++ - '0');
+		*fields[i] = v;
+	}
+	return p;
+}
+
+/*
+ * read_ops_text - Parse the requests of a mapped text trace into
+ *     trace->ops. The body is cut into one slice per thread at line
+ *     boundaries; each thread parses its slice into its own op array and
+ *     the arrays are copied behind each other in file order. The first
+ *     slice parses straight into trace->ops, so only the others are
+ *     copied. Op counts and max_index are checked per slice before
+ *     anything is stitched. Returns the number of ops read.
+ */
+static unsigned read_ops_text(const char *body, const char *end,
+							  trace_t *trace, char *path, unsigned *max_index)
+{
+	chunk_t chunks[MAX_PARSERS];
+	pthread_t tids[MAX_PARSERS];
+	size_t len = end - body;
+	unsigned op_index, max = 0;
+	struct timespec t0, t1;
+	int n, i;
+
+	clock_gettime(CLOCK_MONOTONIC, &t0);
+	n = parse_threads > 0 ? parse_threads : (int)sysconf(_SC_NPROCESSORS_ONLN);
+	if (n > (int)(len / MIN_CHUNK))
+		n = len / MIN_CHUNK;
+	n = (n < 1) ? 1 : (n > MAX_PARSERS) ? MAX_PARSERS : n;
+
+	/* Cut each slice at the first newline after its even share */
+	for (i = 0; i < n; i++)
+	{
+		const char *lo = (i == 0) ? body : chunks[i - 1].hi;
+		const char *hi = (i == n - 1) ? end : body + len / n * (i + 1);
+
+		if (hi < lo)
+			hi = lo;
+		if (hi < end)
+		{
+			const char *nl = memchr(hi, '\n', end - hi);
+			hi = nl ? nl + 1 : end;
+		}
+		memset(&chunks[i], 0, sizeof(chunk_t));
+		chunks[i].lo = lo;
+		chunks[i].hi = hi;
+		chunks[i].limit = trace->num_ops;
+	}
+	chunks[0].ops = trace->ops;
+	chunks[0].cap = trace->num_ops;
+	chunks[0].fixed = 1;
+
+	for (i = 1; i < n; i++)
+		if (pthread_create(&tids[i], NULL, parse_chunk, &chunks[i]) != 0)
+			unix_error("pthread_create failed in read_trace");
+	parse_chunk(&chunks[0]);
+	for (i = 1; i < n; i++)
+		pthread_join(tids[i], NULL);
+
+	/* Validate every slice, then stitch them in file order */
 	op_index = 0;
-	while (fscanf(tracefile, "%s", type) != EOF)
+	for (i = 0; i < n; i++)
 	{
-		switch (type[0])
+		chunk_t *c = &chunks[i];
+
+		if (c->bad)
 		{
-		case 'a':
-			fscanf(tracefile, "%u %u", &index, &size);
-			trace->ops[op_index].type = ALLOC;
-			trace->ops[op_index].index = index;
-			trace->ops[op_index].size = size;
-			max_index = (index > max_index) ? index : max_index;
-			break;
-		case 'r':
-			fscanf(tracefile, "%u %u", &index, &size);
-			trace->ops[op_index].type = REALLOC;
-			trace->ops[op_index].index = index;
-			trace->ops[op_index].size = size;
-			max_index = (index > max_index) ? index : max_index;
-			break;
-		case 'f':
-			fscanf(tracefile, "%ud", &index);
-			trace->ops[op_index].type = FREE;
-			trace->ops[op_index].index = index;
+			const char *p;
+			long line = HDRLINES;
+			for (p = body; p < c->bad; p++)
+				line += (*p == '\n');
+			printf("Bogus request (%c) at line %ld in tracefile %s\n",
+				   *c->bad, line, path);
+			exit(1);
+		}
+		if (c->overflow || op_index + c->nops > (unsigned)trace->num_ops)
+		{
+			printf("More requests than the header's %d in tracefile %s\n",
+				   trace->num_ops, path);
+			exit(1);
+		}
+		if (i > 0)
+		{
+			memcpy(trace->ops + op_index, c->ops, c->nops * sizeof(traceop_t));
+			free(c->ops);
+		}
+		max = (c->max_index > max) ? c->max_index : max;
+		op_index += c->nops;
+	}
+	*max_index = max;
+
+	clock_gettime(CLOCK_MONOTONIC, &t1);
+	if (verbose > 1)
+	{
+		double secs = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) * 1e-9;
+		printf("Parsed %u requests (%zu bytes) with %d thread%s in %.1f ms (%.0f MB/s)\n",
+			   op_index, len, n, n > 1 ? "s" : "", secs * 1e3, len / secs / 1e6);
+	}
+	return op_index;
+}
+
+/*
+ * parse_chunk - Thread body of read_ops_text: parse the requests of one
+ *     slice. Accepts what the old fscanf loop did: a type token whose
+ *     first character is a, r or f, followed by the id (and size), all
+ *     separated by any white space. Stops at the first request that does
+ *     not parse or when the slice holds more ops than the whole trace.
+ */
+static void *parse_chunk(void *arg)
+{
+	chunk_t *c = (chunk_t *)arg;
+	const char *p = c->lo, *end = c->hi;
+	traceop_t *ops = c->ops;		/* kept in locals: the op stores */
+	unsigned nops = 0, cap = c->cap; /* may alias *c */
+	unsigned max = 0;
+
+	if (!c->fixed)
+	{
+		cap = (end - p) / 8 + 16; /* requests average about 10 bytes */
+		if (cap > c->limit)
+			cap = c->limit;
+		if ((ops = (traceop_t *)malloc((cap + 1) * sizeof(traceop_t))) == NULL)
+			unix_error("malloc failed in parse_chunk");
+	}
+
+	for (;;)
+	{
+		const char *req;
+		unsigned vals[2] = {0, 0};
+		int nvals, k, type;
+		traceop_t *op;
+
+		while (p < end && IS_SPACE(*p))
+			p++;
+		if (p == end)
 			break;
+		req = p;
+		switch (*p)
+		{
+		case 'a': type = ALLOC; nvals = 2; break;
+		case 'r': type = REALLOC; nvals = 2; break;
+		case 'f': type = FREE; nvals = 1; break;
 		default:
-			printf("Bogus type character (%c) in tracefile %s\n",
-				   type[0], path);
+			c->bad = req;
+			goto out;
+		}
+		while (p < end && !IS_SPACE(*p))
+			p++;
+		for (k = 0; k < nvals; k++)
+		{
+			unsigned v = 0;
+			while (p < end && IS_SPACE(*p))
+				p++;
+			if (p == end || !IS_DIGIT(*p))
+			{
+				c->bad = req;
+				goto out;
+			}
+			while (p < end && IS_DIGIT(*p))
+				v = v * 10 + (*p++ - '0');
+			vals[k] = v;
+		}
+
+		if (nops == cap)
+		{
+			if (c->fixed || cap == c->limit)
+			{
+				c->overflow = 1;
+				goto out;
+			}
+			cap = (cap > c->limit / 2) ? c->limit : 2 * cap;
+			if ((ops = (traceop_t *)realloc(ops, cap * sizeof(traceop_t))) == NULL)
+				unix_error("realloc failed in parse_chunk");
+		}
+		op = &ops[nops++];
+		op->type = type;
+		op->index = vals[0];
+		op->size = vals[1];
+		if (type != FREE && vals[0] > max)
+			max = vals[0];
+	}
+out:
+	c->ops = ops;
+	c->nops = nops;
+	c->cap = cap;
+	c->max_index = max;
+	return NULL;
+}
+
+/*
+ * read_ops_z - Decode the ops of a compressed trace (tracez.h) straight
+ *     into trace->ops, one block at a time, so that only two block
+ *     buffers and a small batch of decoded ops are ever held besides the
+ *     op array. Returns the number of ops read; a corrupt block or more
+ *     ops than the header promised is fatal.
+ */
+static unsigned read_ops_z(tz_reader_t *tz, trace_t *trace, char *path,
+						   unsigned *max_index)
+{
+	static const unsigned char type_of[] = {
+		[TZ_ALLOC] = ALLOC, [TZ_FREE] = FREE, [TZ_REALLOC] = REALLOC};
+	tz_op_t batch[1024];
+	unsigned op_index = 0, max = 0;
+	int i, n;
+
+	while ((n = tz_read(tz, batch, 1024)) > 0)
+	{
+		if (op_index + n > (unsigned)trace->num_ops)
+		{
+			printf("More requests than the header's %d in tracefile %s\n",
+				   trace->num_ops, path);
 			exit(1);
 		}
-		op_index++;
+		for (i = 0; i < n; i++)
+		{
+			traceop_t *op = &trace->ops[op_index + i];
+			op->type = type_of[batch[i].type];
+			op->index = batch[i].id;
+			op->size = batch[i].size;
+			if (batch[i].type != TZ_FREE && batch[i].id > max)
+				max = batch[i].id;
+		}
+		op_index += n;
 	}
-	fclose(tracefile);
-	assert(max_index == trace->num_ids - 1);
-	assert(trace->num_ops == op_index);
+	if (n < 0)
+	{
+		printf("Corrupt block in tracefile %s\n", path);
+		exit(1);
+	}
+	tz_close(tz);
+	*max_index = max;
+	return op_index;
+}
 
-	return trace;
+/*
+ * renumber_ids - Replace the trace's ids with blocks[] slots reused by
+ *     liveness: an alloc takes the most recently freed slot, a free gives
+ *     its slot back. blocks[] then needs only as many entries as there are
+ *     live blocks at the peak, and the hot ones stay in a few cache lines
+ *     instead of being scattered over num_ids entries. Ops that touch an
+ *     id with no live slot (realloc or free before any alloc) get a fresh
+ *     slot, just as they got an untouched entry before.
+ */
+static void renumber_ids(trace_t *trace)
+{
+	int *slot_of;		/* id -> slot, -1 while the id is not live */
+	unsigned *spare;	/* freed slots, most recent on top */
+	unsigned nspare = 0, nslots = 0;
+	int i;
+
+	if ((slot_of = (int *)malloc(trace->num_ids * sizeof(int))) == NULL ||
+		(spare = (unsigned *)malloc(trace->num_ops * sizeof(unsigned))) == NULL)
+		unix_error("malloc failed in renumber_ids");
+	memset(slot_of, -1, trace->num_ids * sizeof(int));
+
+	for (i = 0; i < trace->num_ops; i++)
+	{
+		traceop_t *op = &trace->ops[i];
+		unsigned id = op->index;
+
+		if (slot_of[id] < 0 || op->type == ALLOC)
+			slot_of[id] = nspare ? spare[--nspare] : nslots++;
+		op->index = slot_of[id];
+		if (op->type == FREE)
+		{
+			spare[nspare++] = slot_of[id];
+			slot_of[id] = -1;
+		}
+	}
+	assert(nslots <= MAX_TRACE_SLOTS);
+	free(slot_of);
+	free(spare);
+
+	trace->num_ids = nslots ? nslots : 1;
+	if ((trace->blocks = realloc(trace->blocks, trace->num_ids * sizeof(char *))) == NULL ||
+		(trace->block_sizes = realloc(trace->block_sizes, trace->num_ids * sizeof(size_t))) == NULL)
+		unix_error("realloc failed in renumber_ids");
 }
 
 /*
@@ -635,6 +1116,7 @@ static int eval_mm_valid(trace_t *trace, int tracenum, range_t **ranges)
 		malloc_error(tracenum, 0, "mm_init failed.");
 		return 0;
 	}
+	mm_check_set_budget(check_budget);
 
 	/* Interpret each operation in the trace in order */
 	for (i = 0; i < trace->num_ops; i++)
@@ -661,6 +1143,11 @@ static int eval_mm_valid(trace_t *trace, int tracenum, range_t **ranges)
 			 */
 			if (add_range(ranges, p, size, tracenum, i) == 0)
 				return 0;
+			if (mm_usable_size(p) < (size_t)size)
+			{
+				malloc_error(tracenum, i, "mm_usable_size is smaller than the request");
+				return 0;
+			}
 
 			/* ADDED: cgw
 			 * fill range with low byte of index.  This will be used later
@@ -691,6 +1178,11 @@ static int eval_mm_valid(trace_t *trace, int tracenum, range_t **ranges)
 			/* Check new block for correctness and add it to range list */
 			if (add_range(ranges, newp, size, tracenum, i) == 0)
 				return 0;
+			if (mm_usable_size(newp) < (size_t)size)
+			{
+				malloc_error(tracenum, i, "mm_usable_size is smaller than the request");
+				return 0;
+			}
 
 			/* ADDED: cgw
 			 * Make sure that the new block contains the data from the old
@@ -702,7 +1194,7 @@ static int eval_mm_valid(trace_t *trace, int tracenum, range_t **ranges)
 				oldsize = size;
 			for (j = 0; j < oldsize; j++)
 			{
-				if (newp[j] != (index & 0xFF))
+				if ((unsigned char)newp[j] != (index & 0xFF))
 				{
 					malloc_error(tracenum, i, "mm_realloc did not preserve the "
 											  "data from old block");
@@ -729,6 +1221,25 @@ static int eval_mm_valid(trace_t *trace, int tracenum, range_t **ranges)
 		default:
 			app_error("Nonexistent request type in eval_mm_valid");
 		}
+
+		if (check_budget && mm_check_errors())
+		{
+			malloc_error(tracenum, i, "mm_checkheap found an inconsistent heap");
+			mm_check_set_budget(0);
+			return 0;
+		}
+	}
+
+	/* Finish with one full sweep, then leave the checker off for timing */
+	if (check_budget)
+	{
+		mm_checkheap(__LINE__);
+		mm_check_set_budget(0);
+		if (mm_check_errors())
+		{
+			malloc_error(tracenum, trace->num_ops - 1, "mm_checkheap found an inconsistent heap");
+			return 0;
+		}
 	}
 
 	/* As far as we know, this is a valid malloc package */
@@ -827,6 +1338,144 @@ static double eval_mm_util(trace_t *trace, int tracenum, range_t **ranges)
 	return ((double)max_total_size / (double)mem_heapsize());
 }
 
+/*
+ * eval_mm_frag - Break the heap down at the trace's peak. A first pass
+ *   over the request sizes finds the op where the live payload is largest
+ *   (the numerator of util); the trace is then replayed and, right after
+ *   that op, every live block and the rest of the heap are classified.
+ *   The replay continues to the end so that heap growth after the peak,
+ *   which util also charges, is reported as well.
+ */
+static void eval_mm_frag(trace_t *trace, frag_stats_t *fs)
+{
+	int i, index, peak_op = -1;
+	long total_size = 0, max_total_size = 0;
+	char *live;
+	char *p;
+
+	/* Pass 1: find the peak using the request sizes only */
+	for (i = 0; i < trace->num_ops; i++)
+	{
+		index = trace->ops[i].index;
+		switch (trace->ops[i].type)
+		{
+		case ALLOC:
+			trace->block_sizes[index] = trace->ops[i].size;
+			total_size += trace->ops[i].size;
+			break;
+		case REALLOC:
+			total_size += trace->ops[i].size - (long)trace->block_sizes[index];
+			trace->block_sizes[index] = trace->ops[i].size;
+			break;
+		case FREE:
+			total_size -= trace->block_sizes[index];
+			break;
+		}
+		if (total_size > max_total_size)
+		{
+			max_total_size = total_size;
+			peak_op = i;
+		}
+	}
+
+	if ((live = (char *)calloc(trace->num_ids, 1)) == NULL)
+		unix_error("live calloc in eval_mm_frag failed");
+	memset(fs, 0, sizeof(*fs));
+
+	/* Pass 2: replay and take the breakdown right after the peak op */
+	mem_reset_brk();
+	if (mm_init() < 0)
+		app_error("mm_init failed in eval_mm_frag");
+	for (i = 0; i < trace->num_ops; i++)
+	{
+		index = trace->ops[i].index;
+		switch (trace->ops[i].type)
+		{
+		case ALLOC:
+			if ((p = mm_malloc(trace->ops[i].size)) == NULL)
+				app_error("mm_malloc failed in eval_mm_frag");
+			trace->blocks[index] = p;
+			trace->block_sizes[index] = trace->ops[i].size;
+			live[index] = 1;
+			break;
+		case REALLOC:
+			if ((p = mm_realloc(trace->blocks[index], trace->ops[i].size)) == NULL)
+				app_error("mm_realloc failed in eval_mm_frag");
+			trace->blocks[index] = p;
+			trace->block_sizes[index] = trace->ops[i].size;
+			live[index] = 1;
+			break;
+		case FREE:
+			mm_free(trace->blocks[index]);
+			live[index] = 0;
+			break;
+		}
+		if (i == peak_op)
+		{
+			for (index = 0; index < trace->num_ids; index++)
+				if (live[index])
+					mm_frag_block(trace->blocks[index], trace->block_sizes[index], &fs->frag);
+			mm_frag_heap(&fs->frag);
+			fs->peak_heap = mem_heapsize();
+		}
+	}
+	fs->final_heap = mem_heapsize();
+	free(live);
+}
+
+/*
+ * eval_mm_realloc - Replay the trace and, before every mm_realloc, ask
+ *   mm_usable_size whether the old block already has room. A grow that
+ *   fits is a call a caller tracking the usable size would not make.
+ *   The call is still made, so the rest of the replay is unchanged and
+ *   the count is for this heap history only.
+ */
+static void eval_mm_realloc(trace_t *trace, realloc_stats_t *rs)
+{
+	int i, index, size;
+	char *p;
+
+	memset(rs, 0, sizeof(*rs));
+	mem_reset_brk();
+	if (mm_init() < 0)
+		app_error("mm_init failed in eval_mm_realloc");
+	for (i = 0; i < trace->num_ops; i++)
+	{
+		index = trace->ops[i].index;
+		size = trace->ops[i].size;
+		switch (trace->ops[i].type)
+		{
+		case ALLOC:
+			if ((p = mm_malloc(size)) == NULL)
+				app_error("mm_malloc failed in eval_mm_realloc");
+			trace->blocks[index] = p;
+			trace->block_sizes[index] = size;
+			break;
+		case REALLOC:
+			rs->reallocs++;
+			if (size > (int)trace->block_sizes[index])
+			{
+				rs->grows++;
+				if ((size_t)size <= mm_usable_size(trace->blocks[index]))
+					rs->in_slack++;
+			}
+			if ((p = mm_realloc(trace->blocks[index], size)) == NULL)
+				app_error("mm_realloc failed in eval_mm_realloc");
+			if (p != trace->blocks[index])
+			{
+				rs->moves++;
+				rs->copied += (size < (int)trace->block_sizes[index]) ? size : trace->block_sizes[index];
+			}
+			trace->blocks[index] = p;
+			trace->block_sizes[index] = size;
+			break;
+		case FREE:
+			mm_free(trace->blocks[index]);
+			break;
+		}
+	}
+}
+
 /*
  * eval_mm_speed - This is the function that is used by fcyc()
  *    to measure the running time of the mm malloc package.
@@ -875,6 +1524,146 @@ static void eval_mm_speed(void *ptr)
 		}
 }
 
+/*
+ * Reference backends for -R. null_* do nothing but stay opaque calls, so
+ * timing them measures the replay loop itself (dispatch, op loads, the
+ * blocks[] stores). bump_* only advance a pointer through a private
+ * arena: no reuse, no headers, and realloc moves without copying since
+ * the speed loop never reads payloads. No allocator does less work per
+ * request, so it bounds what the replay loop can show. The arena wraps
+ * when it runs out and is never touched, so it costs no cache misses.
+ */
+#define BUMP_ARENA (MAX_HEAP + (1 << 20))
+
+static char bump_dummy[ALIGNMENT];
+static char *bump_arena, *bump_ptr;
+
+static __attribute__((noinline)) void *null_malloc(size_t size)
+{
+	__asm__ __volatile__("" : : "r"(size) : "memory");
+	return bump_dummy;
+}
+
+static __attribute__((noinline)) void null_free(void *ptr)
+{
+	__asm__ __volatile__("" : : "r"(ptr) : "memory");
+}
+
+static __attribute__((noinline)) void *null_realloc(void *ptr, size_t size)
+{
+	__asm__ __volatile__("" : : "r"(ptr), "r"(size) : "memory");
+	return bump_dummy;
+}
+
+static __attribute__((noinline)) void *bump_malloc(size_t size)
+{
+	size_t need = (size + ALIGNMENT - 1) & ~(size_t)(ALIGNMENT - 1);
+	char *p;
+
+	if (bump_ptr + need > bump_arena + BUMP_ARENA)
+		bump_ptr = bump_arena;
+	p = bump_ptr;
+	bump_ptr += need;
+	return p;
+}
+
+static __attribute__((noinline)) void bump_free(void *ptr)
+{
+	__asm__ __volatile__("" : : "r"(ptr) : "memory");
+}
+
+static __attribute__((noinline)) void *bump_realloc(void *ptr, size_t size)
+{
+	__asm__ __volatile__("" : : "r"(ptr) : "memory");
+	return bump_malloc(size);
+}
+
+/*
+ * eval_null_speed - the eval_mm_speed loop against the null backend
+ */
+static void eval_null_speed(void *ptr)
+{
+	int i, index, size, newsize;
+	char *p, *newp, *oldp, *block;
+	trace_t *trace = ((speed_t *)ptr)->trace;
+
+	for (i = 0; i < trace->num_ops; i++)
+		switch (trace->ops[i].type)
+		{
+
+		case ALLOC: /* null_malloc */
+			index = trace->ops[i].index;
+			size = trace->ops[i].size;
+			if ((p = null_malloc(size)) == NULL)
+				app_error("null_malloc error in eval_null_speed");
+			trace->blocks[index] = p;
+			break;
+
+		case REALLOC: /* null_realloc */
+			index = trace->ops[i].index;
+			newsize = trace->ops[i].size;
+			oldp = trace->blocks[index];
+			if ((newp = null_realloc(oldp, newsize)) == NULL)
+				app_error("null_realloc error in eval_null_speed");
+			trace->blocks[index] = newp;
+			break;
+
+		case FREE: /* null_free */
+			index = trace->ops[i].index;
+			block = trace->blocks[index];
+			null_free(block);
+			break;
+
+		default:
+			app_error("Nonexistent request type in eval_null_speed");
+		}
+}
+
+/*
+ * eval_bump_speed - the eval_mm_speed loop against the bump backend
+ */
+static void eval_bump_speed(void *ptr)
+{
+	int i, index, size, newsize;
+	char *p, *newp, *oldp, *block;
+	trace_t *trace = ((speed_t *)ptr)->trace;
+
+	if (bump_arena == NULL && (bump_arena = malloc(BUMP_ARENA)) == NULL)
+		unix_error("bump arena malloc in eval_bump_speed failed");
+	bump_ptr = bump_arena;
+
+	for (i = 0; i < trace->num_ops; i++)
+		switch (trace->ops[i].type)
+		{
+
+		case ALLOC: /* bump_malloc */
+			index = trace->ops[i].index;
+			size = trace->ops[i].size;
+			if ((p = bump_malloc(size)) == NULL)
+				app_error("bump_malloc error in eval_bump_speed");
+			trace->blocks[index] = p;
+			break;
+
+		case REALLOC: /* bump_realloc */
+			index = trace->ops[i].index;
+			newsize = trace->ops[i].size;
+			oldp = trace->blocks[index];
+			if ((newp = bump_realloc(oldp, newsize)) == NULL)
+				app_error("bump_realloc error in eval_bump_speed");
+			trace->blocks[index] = newp;
+			break;
+
+		case FREE: /* bump_free */
+			index = trace->ops[i].index;
+			block = trace->blocks[index];
+			bump_free(block);
+			break;
+
+		default:
+			app_error("Nonexistent request type in eval_bump_speed");
+		}
+}
+
 /*
  * eval_libc_valid - We run this function to make sure that the
  *    libc malloc can run to completion on the set of traces.
@@ -1061,16 +1850,162 @@ void malloc_error(int tracenum, int opnum, char *msg)
 /*
  * usage - Explain the command line arguments
  */
+/*
+ * printfrag - Print the fragmentation breakdown of each trace. Columns
+ *     are percentages of the final heap and, together with "late" (heap
+ *     growth after the peak), add up to 100%.
+ */
+static void printfrag(int n, stats_t *stats, frag_stats_t *frags)
+{
+	int i;
+
+	printf("%5s%6s%8s%8s%7s%8s%7s%7s%7s%7s%7s%7s\n",
+		   "trace", "util", "payload", "hdr/ftr", "align", "448/112",
+		   "split", "cached", "extern", "tail", "other", "late");
+	for (i = 0; i < n; i++)
+	{
+		mm_frag_t *f = &frags[i].frag;
+		double heap = (double)frags[i].final_heap / 100.0;
+
+		if (!stats[i].valid || frags[i].final_heap == 0)
+		{
+			printf("%2d%9s\n", i, "-");
+			continue;
+		}
+		printf("%2d%8.1f%%%7.1f%%%7.1f%%%6.1f%%%7.1f%%%6.1f%%%6.1f%%%6.1f%%%6.1f%%%6.1f%%%6.1f%%\n",
+			   i, stats[i].util * 100.0,
+			   f->payload / heap, f->hdr_ftr / heap, f->align / heap,
+			   f->special / heap, f->remainder / heap, f->cached / heap,
+			   f->external / heap, f->tail / heap, f->other / heap,
+			   (frags[i].final_heap - frags[i].peak_heap) / heap);
+	}
+}
+
+/*
+ * printcalib - Print mm, null and bump throughput per trace. "loop" is
+ *     the null backend's time as a share of mm's; the adj columns divide
+ *     the ops by the time left after subtracting it.
+ */
+static void printcalib(int n, stats_t *stats, stats_t *null_stats,
+					   stats_t *bump_stats)
+{
+	int i;
+	double ops = 0, secs = 0, nsecs = 0, bsecs = 0;
+
+	printf("%5s%9s%9s%9s%7s%10s%10s\n",
+		   "trace", "mm", "null", "bump", "loop", "mm adj", "bump adj");
+	for (i = 0; i < n; i++)
+	{
+		if (!stats[i].valid)
+		{
+			printf("%2d%10s\n", i, "-");
+			continue;
+		}
+		printf("%2d%12.0f%9.0f%9.0f%6.1f%%%10.0f%10.0f\n",
+			   i, stats[i].ops / 1e3 / stats[i].secs,
+			   stats[i].ops / 1e3 / null_stats[i].secs,
+			   stats[i].ops / 1e3 / bump_stats[i].secs,
+			   100.0 * null_stats[i].secs / stats[i].secs,
+			   stats[i].ops / 1e3 / (stats[i].secs - null_stats[i].secs),
+			   stats[i].ops / 1e3 / (bump_stats[i].secs - null_stats[i].secs));
+		ops += stats[i].ops;
+		secs += stats[i].secs;
+		nsecs += null_stats[i].secs;
+		bsecs += bump_stats[i].secs;
+	}
+	if (ops > 0)
+		printf("%5s%9.0f%9.0f%9.0f%6.1f%%%10.0f%10.0f\n",
+			   "Total", ops / 1e3 / secs, ops / 1e3 / nsecs, ops / 1e3 / bsecs,
+			   100.0 * nsecs / secs, ops / 1e3 / (secs - nsecs),
+			   ops / 1e3 / (bsecs - nsecs));
+}
+
+/*
+ * printrealloc - Print the realloc traffic of each trace: how many grows
+ *     the old block's slack would have absorbed, and what the moves cost.
+ */
+static void printrealloc(int n, stats_t *stats, realloc_stats_t *reallocs)
+{
+	int i;
+	realloc_stats_t t = {0};
+
+	printf("%5s%10s%9s%9s%8s%9s%12s\n",
+		   "trace", "reallocs", "grows", "slack", "slack%", "moves", "copied KB");
+	for (i = 0; i < n; i++)
+	{
+		realloc_stats_t *r = &reallocs[i];
+
+		if (!stats[i].valid)
+		{
+			printf("%2d%13s\n", i, "-");
+			continue;
+		}
+		if (r->reallocs == 0)
+			continue;
+		printf("%2d%13ld%9ld%9ld%7.1f%%%9ld%12.0f\n",
+			   i, r->reallocs, r->grows, r->in_slack,
+			   r->grows ? 100.0 * r->in_slack / r->grows : 0.0,
+			   r->moves, r->copied / 1024);
+		t.reallocs += r->reallocs;
+		t.grows += r->grows;
+		t.in_slack += r->in_slack;
+		t.moves += r->moves;
+		t.copied += r->copied;
+	}
+	printf("%5s%10ld%9ld%9ld%7.1f%%%9ld%12.0f\n",
+		   "Total", t.reallocs, t.grows, t.in_slack,
+		   t.grows ? 100.0 * t.in_slack / t.grows : 0.0,
+		   t.moves, t.copied / 1024);
+}
+
+/*
+ * printsplit - Print each trace's util with one-ended and two-ended
+ *     placement and the difference in percentage points.
+ */
+static void printsplit(int n, stats_t *stats, double *base_util)
+{
+	int i, m = 0;
+	double base = 0, split = 0;
+
+	printf("%5s%8s%10s%8s\n", "trace", "base", "two-end", "delta");
+	for (i = 0; i < n; i++)
+	{
+		if (!stats[i].valid)
+		{
+			printf("%2d%11s\n", i, "-");
+			continue;
+		}
+		printf("%2d%10.1f%%%9.1f%%%+8.1f\n", i, base_util[i] * 100.0,
+			   stats[i].util * 100.0, (stats[i].util - base_util[i]) * 100.0);
+		base += base_util[i];
+		split += stats[i].util;
+		m++;
+	}
+	if (m > 0)
+		printf("%5s%7.1f%%%9.1f%%%+8.1f\n", "Avg", base / m * 100.0,
+			   split / m * 100.0, (split - base) / m * 100.0);
+}
+
 static void usage(void)
 {
-	fprintf(stderr, "Usage: mdriver [-hvVal] [-f <file>] [-t <dir>]\n");
+	fprintf(stderr, "Usage: mdriver [-hvValFRU] [-f <file>] [-t <dir>] [-s <bytes>] [-c <n>] [-j <n>] [-N <bytes>] [-L <bytes>] [-O <n>] [-T <bytes>]\n");
 	fprintf(stderr, "Options\n");
 	fprintf(stderr, "\t-a         Don't check the team structure.\n");
+	fprintf(stderr, "\t-c <n>     Check <n> heap blocks per op while validating.\n");
 	fprintf(stderr, "\t-f <file>  Use <file> as the trace file.\n");
+	fprintf(stderr, "\t-F         Break down fragmentation at each trace's peak.\n");
 	fprintf(stderr, "\t-g         Generate summary info for autograder.\n");
 	fprintf(stderr, "\t-h         Print this message.\n");
+	fprintf(stderr, "\t-j <n>     Parse text traces with <n> threads (default: one per CPU).\n");
 	fprintf(stderr, "\t-l         Run libc malloc as well.\n");
+	fprintf(stderr, "\t-L <bytes> Put payloads of <bytes>..4096 bytes on 64-byte boundaries.\n");
+	fprintf(stderr, "\t-N <bytes> Bump-allocate small requests from <bytes> nursery chunks.\n");
+	fprintf(stderr, "\t-O <n>     Reorder <n> free-list nodes by size and address per heap growth.\n");
+	fprintf(stderr, "\t-R         Time null and bump backends; report Kops without loop overhead.\n");
+	fprintf(stderr, "\t-s <bytes> Sample mm_malloc every <bytes> on average; print heap profiles.\n");
 	fprintf(stderr, "\t-t <dir>   Directory to find default traces.\n");
+	fprintf(stderr, "\t-T <bytes> Place blocks of <bytes> and up from the high end of free blocks.\n");
+	fprintf(stderr, "\t-U         Count realloc grows that fit in mm_usable_size.\n");
 	fprintf(stderr, "\t-v         Print per-trace performance breakdowns.\n");
 	fprintf(stderr, "\t-V         Print additional debug info.\n");
 }
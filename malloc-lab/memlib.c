@@ -10,6 +10,7 @@
 #include <sys/mman.h>
 #include <string.h>
 #include <errno.h>
+#include <stdint.h>
 
 #include "memlib.h"
 #include "config.h"
@@ -52,8 +53,8 @@ void mem_reset_brk()
 
 /* 
  * mem_sbrk - simple model of the sbrk function. Extends the heap 
- *    by incr bytes and returns the start address of the new area. In
- *    this model, the heap cannot be shrunk.
+ *    by incr bytes and returns the start address of the new area. A
+ *    negative incr is rejected; the heap is shrunk with mem_shrink.
  */
 void *mem_sbrk(int incr) 
 {
@@ -68,6 +69,37 @@ void *mem_sbrk(int incr)
     return (void *)old_brk;
 }
 
+/*
+ * mem_shrink - give back the top decr bytes of the heap (the model's
+ *    negative sbrk). The pages are also dropped from the resident set.
+ */
+int mem_shrink(size_t decr)
+{
+    if (decr > (size_t)(mem_brk - mem_start_brk)) {
+	errno = EINVAL;
+	return -1;
+    }
+    mem_brk -= decr;
+    mem_decommit(mem_brk, decr);
+    return 0;
+}
+
+/*
+ * mem_decommit - release the physical pages wholly inside [addr, addr+len)
+ *    while keeping the range in the heap; the next touch faults in zero
+ *    pages. Returns the number of bytes released.
+ */
+size_t mem_decommit(void *addr, size_t len)
+{
+    size_t pagesize = mem_pagesize();
+    uintptr_t lo = ((uintptr_t)addr + pagesize - 1) & ~(pagesize - 1);
+    uintptr_t hi = ((uintptr_t)addr + len) & ~(pagesize - 1);
+
+    if (hi <= lo || madvise((void *)lo, hi - lo, MADV_DONTNEED) != 0)
+	return 0;
+    return hi - lo;
+}
+
 /*
  * mem_heap_lo - return address of the first heap byte
  */
@@ -99,3 +131,43 @@ size_t mem_pagesize()
 {
     return (size_t)getpagesize();
 }
+
+/*
+ * mem_map_reserve - reserve len bytes (rounded up to pages) of address
+ *    space outside the heap. Nothing is accessible until committed, and
+ *    no memory is charged for the range. Returns NULL on failure.
+ */
+void *mem_map_reserve(size_t len)
+{
+    size_t pagesize = mem_pagesize();
+    void *addr;
+
+    len = (len + pagesize - 1) & ~(pagesize - 1);
+    addr = mmap(NULL, len, PROT_NONE,
+		MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    return (addr == MAP_FAILED) ? NULL : addr;
+}
+
+/*
+ * mem_map_commit - make the pages covering [addr, addr+len) of a reserved
+ *    range readable and writable. They are zero-filled on first touch.
+ *    Returns 0, or -1 if the kernel refused.
+ */
+int mem_map_commit(void *addr, size_t len)
+{
+    size_t pagesize = mem_pagesize();
+    uintptr_t lo = (uintptr_t)addr & ~(pagesize - 1);
+    uintptr_t hi = ((uintptr_t)addr + len + pagesize - 1) & ~(pagesize - 1);
+
+    return mprotect((void *)lo, hi - lo, PROT_READ | PROT_WRITE);
+}
+
+/*
+ * mem_map_release - unmap a range returned by mem_map_reserve
+ */
+void mem_map_release(void *addr, size_t len)
+{
+    size_t pagesize = mem_pagesize();
+
+    munmap(addr, (len + pagesize - 1) & ~(pagesize - 1));
+}
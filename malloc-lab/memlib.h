@@ -4,8 +4,15 @@ void mem_init(void);
 void mem_deinit(void);
 void *mem_sbrk(int incr);
 void mem_reset_brk(void); 
+int mem_shrink(size_t decr);
+size_t mem_decommit(void *addr, size_t len);
 void *mem_heap_lo(void);
 void *mem_heap_hi(void);
 size_t mem_heapsize(void);
 size_t mem_pagesize(void);
 
+/* Mappings outside the heap: reserve address space, commit pages later */
+void *mem_map_reserve(size_t len);
+int mem_map_commit(void *addr, size_t len);
+void mem_map_release(void *addr, size_t len);
+
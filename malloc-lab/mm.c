@@ -6,6 +6,33 @@
  * - 삽입: 해당 group 헤드에 LIFO
  * - 검색: 요청 크기에 해당하는 group부터 위로 올라가며 first-fit (옵션: 동일 group 내 best-fit)
  * - 병합(coalesce) 시 이웃 free 블록을 리스트에서 제거 → 사이즈 합치기 → 새 사이즈 group에 재삽입
+ * - malloc/free/realloc/extend_heap/coalesce/find_fit에 USDT probe (mm_probe.h)
+ * - 카운터는 mm_stats 페이지에 relaxed store로 갱신 (mm_stats.h, mmstat 도구)
+ * - 바이트 간격 표본 추출 프로파일러: 표본 블록은 헤더 bit1(SAMPLED)로 표시 (mm_sample.h)
+ * - mm_checkheap: 전체 검사 + 연산마다 budget 블록씩 커서로 훑는 점진 검사
+ * - realloc 이동 시 큰 payload는 non-temporal store로 복사 (캐시 오염 방지)
+ * - mm_malloc_near: hint 주변(NEAR_REGION 이내) free 블록을 우선하는 할당
+ * - mm_heap_set_limit: committed 바이트(sbrk 총량 - decommit한 페이지)에 soft/hard 상한.
+ *   soft를 넘으면 회수(꼬리 반납 + 큰 free 블록의 페이지 decommit), hard를 넘는
+ *   확장은 실패. decommit한 free 블록은 헤더/풋터 bit2(DECOMMITTED)로 표시
+ * - 정확한 크기 인덱스: 크기 → 그 크기 free 블록 중 대표 하나 (open addressing 해시).
+ *   같은 크기 블록은 class 리스트에서 대표 뒤에 붙여 연속으로 유지하고,
+ *   find_fit은 best-fit 스캔 전에 인덱스에서 완벽 일치를 O(1)로 찾는다
+ * - 작은 크기 batch refill: find_fit이 실패하면 힙을 한 번에 여러 블록만큼 늘려
+ *   미리 쪼개고, 나머지는 크기별 warm 리스트(헤더상 할당 상태)에 두었다가 O(1)로 꺼냄.
+ *   힙을 다시 늘려야 할 때는 먼저 남은 warm 블록을 free 리스트로 돌려줌
+ * - nursery 모드(mm_nursery_set): 작은 요청은 chunk 안에서 bump 할당, chunk는 살아 있는
+ *   객체 수가 0이 되면 통째로 재활용 (헤더 bit2 = NURSERY)
+ * - 캐시 라인 정렬 모드(mm_align_set): 중간 크기 요청의 payload를 64B 경계에 둠.
+ *   앞쪽 패딩은 MIN_FREE_BLK 이상으로 잡아 free 블록으로 리스트에 돌려줌
+ * - free 리스트 재정렬(mm_reorder_step, mm_reorder_set_budget): class 리스트를 조금씩
+ *   (크기, 주소) 순으로 병합 정렬해 LIFO 삽입으로 흩어진 리스트의 지역성을 되살림
+ * - 양끝 배치 모드(mm_split_set): 큰 블록은 free 블록의 위쪽 끝에서 잘라 작은 블록과
+ *   주소가 섞이지 않게 함 (작은 것은 아래에서 위로, 큰 것은 위에서 아래로)
+ * - mm_usable_size: 헤더로 O(1)에 실제 쓸 수 있는 payload 크기 (8B 올림, 분할 안 한
+ *   자투리 포함)를 알려 줘서, 늘어나는 버퍼가 realloc 전에 블록을 끝까지 쓰게 함
+ * - 예약 버퍼(mm_reserve, mm_grow, mm_release): 힙 밖에 주소 공간만 잡아 두고 자랄 때
+ *   페이지만 commit. 절대 이동하지 않으므로 복사가 없음 (memlib의 mem_map_*)
  */
 
 #include <stdio.h>
@@ -14,9 +41,15 @@
 #include <unistd.h>
 #include <string.h>
 #include <stdint.h>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 #include "mm.h"
 #include "memlib.h"
+#include "mm_probe.h"
+#include "mm_stats.h"
+#include "mm_sample.h"
 
 /*********************************************************
  * Team info
@@ -39,6 +72,7 @@ team_t team = {
 #define DSIZE       8               /* double word */
 #define CHUNKSIZE   (1 << 12)       /* heap extend size: 4KB (init-time) */
 #define MAX(x,y)    ((x) > (y) ? (x) : (y))
+#define MIN(x,y)    ((x) < (y) ? (x) : (y))
 
 /* Pack a size and allocated bit into a word */
 #define PACK(size, alloc) ((size) | (alloc))
@@ -51,6 +85,27 @@ team_t team = {
 #define GET_SIZE(p)  (GET(p) & ~0x7)
 #define GET_ALLOC(p) (GET(p) & 0x1)
 
+/* 할당 블록 헤더의 bit1: 힙 프로파일러 표본 여부 (free 시 PACK으로 지워짐) */
+#define SAMPLED           0x2
+#define GET_SAMPLED(p)    (GET(p) & SAMPLED)
+
+/* bit2: free 블록 헤더/풋터에서는 내부 페이지를 decommit했다는 표시 (리스트에서
+ * 빠질 때 다시 셈), 할당된 payload 앞 헤더에서는 nursery 객체라는 표시.
+ * 보통의 할당 블록 헤더는 항상 PACK으로 쓰이므로 bit2가 0이다. */
+#define DECOMMITTED       0x4
+#define GET_DECOMMITTED(p) (GET(p) & DECOMMITTED)
+#define NURSERY           0x4
+#define IS_NURSERY(bp)    (GET(HDRP(bp)) & NURSERY)
+
+/* Nursery object: 8B header [object size][offset from chunk << 3 | NURSERY | 1] */
+#define NURSERY_HDR        DSIZE
+#define NURSERY_SIZE(bp)   (*(unsigned int *)((char *)(bp) - NURSERY_HDR))
+#define NURSERY_CHUNK(bp)  ((nursery_chunk_t *)((char *)(bp) - (GET(HDRP(bp)) >> 3)))
+
+/* chunk 크기 범위: 가장 큰 객체 하나는 들어가야 하고, 오프셋 << 3이 32비트에 들어가야 함 */
+#define NURSERY_CHUNK_MIN  (ALIGN(sizeof(nursery_chunk_t)) + NURSERY_MAX + NURSERY_HDR)
+#define NURSERY_CHUNK_MAX  (((size_t)1 << 29) - DSIZE)
+
 /* Given block ptr bp, compute address of its header and footer */
 #define HDRP(bp)     ((char *)(bp) - WSIZE)
 #define FTRP(bp)     ((char *)(bp) + GET_SIZE(HDRP(bp)) - DSIZE)
@@ -71,25 +126,135 @@ team_t team = {
 /* Minimum free block size: hdr(4)+ftr(4)+pred(8)+succ(8)=24 */
 #define MIN_FREE_BLK (ALIGN(WSIZE + WSIZE + DSIZE + DSIZE))  /* 24 */
 
+/* realloc 복사: 이 크기 이상이면 streaming store (mm_copy_set_threshold로 조절) */
+#ifndef NT_COPY_THRESHOLD
+#define NT_COPY_THRESHOLD (512 * 1024)
+#endif
+
+/* mm_malloc_near: hint에서 이 거리 안의 블록을 "가깝다"고 봄 (같은 페이지 근방) */
+#ifndef NEAR_REGION
+#define NEAR_REGION 4096
+#endif
+
+/* 정확한 크기 인덱스: 슬롯 수(2의 거듭제곱), 이 비율 이상 차면 새 크기는 색인 안 함 */
+#ifndef EXACT_SLOTS
+#define EXACT_SLOTS 4096
+#endif
+#define EXACT_MAX_LOAD (EXACT_SLOTS / 4 * 3)
+
+/* nursery: 이 크기 이하 요청만 bump 할당 (mm_nursery_set으로 켬) */
+#define NURSERY_MAX     256
+
+/* 캐시 라인 정렬 모드: 정렬 단위, find_fit_aligned가 group마다 보는 블록 수 */
+#define LINE_SIZE       64
+#define ALIGNED_SCAN    32
+
+/* batch refill: 이 크기 이하 블록만, 연속 refill마다 batch를 2배로 (최대 WARM_BATCH_MAX).
+ * 같은 크기가 WARM_BURST번 연달아 find_fit에 실패했을 때(burst)만 refill한다 */
+#define WARM_MAX        128
+#define WARM_BATCH_MAX  32
+#define WARM_BURST      4
+
 /* Segregated list config */
 #define NLISTS 16
+#if NLISTS != MM_STATS_NCLASS
+#error "mm_stats.h: MM_STATS_NCLASS must match NLISTS"
+#endif
 
 /* Globals */
 static char *pPrologueData = NULL;   /* prologue payload pointer */
 static char *headers[NLISTS];        /* heads of segregated explicit free lists */
+static size_t ntCopyThreshold = NT_COPY_THRESHOLD;
+
+/* Exact-size index: size → first free block of that size in its class list */
+typedef struct {
+    size_t size;                     /* 0 = empty slot */
+    char *rep;
+} exact_slot_t;
+static exact_slot_t exactIndex[EXACT_SLOTS];
+static int exactUsed = 0;
+
+/* Warm lists: pre-split blocks by size (size / DSIZE), linked through the payload */
+static char *warmList[WARM_MAX / DSIZE + 1];
+static int   warmBatch[WARM_MAX / DSIZE + 1];
+static uint32_t warmMask = 0;        /* bit idx = warmList[idx]가 비어 있지 않음 */
+static size_t warmMissSize = 0;      /* 마지막으로 find_fit에 실패한 작은 크기 */
+static int   warmMissRun = 0;        /* 그 크기가 연달아 실패한 횟수 */
+
+/* Nursery: bump chunks for small requests (0 = off) */
+typedef struct {
+    uint32_t live;                   /* objects not yet freed */
+    uint32_t pad;
+    char *bump;                      /* next object header */
+    char *end;                       /* end of the chunk payload */
+    char *start;                     /* first object header */
+} nursery_chunk_t;
+static size_t nurseryChunk = 0;
+static nursery_chunk_t *nurseryCur = NULL, *nurserySpare = NULL;
+
+/* Cache-line placement (mm_align_set): payload sizes in [alignLo, alignHi]; 0 = off */
+static size_t alignLo = 0, alignHi = 0;
+
+/* Two-ended placement (mm_split_set): blocks of at least splitHigh bytes are cut
+ * from the high end of a free block; 0 = off */
+static size_t splitHigh = 0;
+
+/* Free-list reordering: state of the incremental natural merge sort */
+enum { RO_START, RO_SCAN, RO_MERGE, RO_SKIP };
+static int   reorderGroup = 0, reorderPhase = RO_START;
+static char *reorderRun = NULL;      /* 지금 보는 run A의 첫 노드 */
+static char *reorderA = NULL;        /* SCAN: A의 끝을 찾는 중, MERGE: A에서 비교할 노드 */
+static char *reorderB = NULL;        /* MERGE/SKIP: run B에서 아직 안 옮긴 첫 노드 */
+static int   reorderBudget = 0;
+
+/* Heap budget (mm_heap_set_limit); 0 = no limit */
+static size_t limitSoft = 0, limitHard = 0;
+static size_t committedBytes = 0;    /* sbrk'd bytes minus decommitted pages */
+static size_t reclaimAt = 0;         /* next soft-limit reclaim when committed passes this */
 
 /* Internal helpers (prototypes) */
 static void *extend_heap(size_t words);
 static void *coalesce(void *bp);
 static void *find_fit(size_t asize);
+static void *find_fit_near(size_t asize, char *hint);
+static void *find_fit_aligned(size_t asize);
+static size_t line_pad(const char *bp);
+static size_t adjust_size(size_t size);
 static void  place(void *bp, size_t asize);
+static void *place_high(void *bp, size_t asize);
+static void *place_found(void *bp, size_t asize);
+static void  carve(void *bp, size_t asize);
+static void *malloc_aligned(size_t adjustedSize);
+static int   warm_burst(size_t asize);
+static void *refill(size_t asize);
+static void *malloc_block(size_t adjustedSize);
+static void  release_block(void *bp);
+static void *nursery_alloc(size_t size);
+static void  nursery_free(void *bp);
+static void  nursery_flush(void);
+static void  warm_flush(void);
 
 static void  insert_node(void *bp);
+static exact_slot_t *exact_find(size_t size);
+static void  exact_delete(exact_slot_t *slot);
 static void  remove_node(void *bp);
 static int   size_to_group(size_t size);
 
 static size_t getFreeSizeOfTail(void);
-void mm_checkheap(int lineno);
+static int   grow_allowed(size_t bytes);
+static void  reclaim(int trim);
+static void  trim_tail(void);
+static size_t decommit_span(void *bp, size_t size);
+static int    recommit_allowed(void *bp);
+static void   keep_decommitted(void *bp);
+static void  copy_payload(void *dst, const void *src, size_t n);
+
+/* Heap checker state (점진 검사용 커서) */
+static char *check_cursor = NULL;    /* 다음에 검사할 블록, NULL이면 첫 블록부터 */
+static int   check_budget = 0;       /* 연산마다 검사할 블록 수 (0 = 끔) */
+static int   check_errors = 0;       /* mm_init 이후 발견한 오류 수 */
+static void  check_step(int lineno);
+static void  check_forget(void *gone, void *survivor);
 
 static int use_color(void) {
   static int cached = -1;
@@ -193,11 +358,186 @@ void mm_heapdump(const char *tag, int opnum, int index, int size)
   /* mm_checkheap(opnum); */
 }
 
-/* 최소한의 뼈대 – 원하면 더 엄격한 검사들을 넣어도 됩니다 */
+/*
+ * Heap consistency checker
+ *
+ * check_block은 블록 하나를 O(1)에 검사한다:
+ *   - 정렬, 힙 범위, 최소 크기, header == footer
+ *   - free 블록: 오른쪽 이웃도 free면 병합 누락
+ *   - free 블록: pred/succ 링크가 서로를 가리키는지, 리스트 머리라면 자기 group의
+ *     headers[]인지, pred가 같은 group의 free 블록인지 (= 리스트 소속 + class 배치)
+ * mm_checkheap은 힙 전체와 각 free 리스트를 한 번에 검사하고,
+ * check_step은 커서를 budget 블록만큼 전진시키며 같은 검사를 나눠서 한다.
+ */
+static void check_report(int lineno, void *bp, const char *what)
+{
+    check_errors++;
+    printf("ERROR [mm_checkheap line %d]: block %p: %s\n", lineno, bp, what);
+}
+
+static int in_heap(const void *p)
+{
+    return (const char *)p >= (char *)mem_heap_lo() && (const char *)p <= (char *)mem_heap_hi();
+}
+
+static void check_block(char *bp, int lineno)
+{
+    unsigned int hdr = GET(HDRP(bp)) & ~SAMPLED;
+    size_t size = GET_SIZE(HDRP(bp));
+
+    if ((uintptr_t)bp % ALIGNMENT) { check_report(lineno, bp, "payload not 8-byte aligned"); return; }
+    if (!in_heap(bp) || !in_heap(bp + size - 1)) { check_report(lineno, bp, "block outside heap"); return; }
+    if (size < MIN_FREE_BLK || size % DSIZE) { check_report(lineno, bp, "bad block size"); return; }
+    if (hdr != GET(FTRP(bp))) { check_report(lineno, bp, "header does not match footer"); return; }
+    if (GET_ALLOC(HDRP(bp)))
+        return;
+
+    if (GET_SAMPLED(HDRP(bp)))
+        check_report(lineno, bp, "free block marked as sampled");
+    if (!GET_ALLOC(HDRP(NEXT_BLKP(bp))))
+        check_report(lineno, bp, "adjacent free blocks were not coalesced");
+
+    int group = size_to_group(size);
+    char *pred = GET_PRED(bp);
+    char *succ = GET_SUCC(bp);
+    if (pred == NULL) {
+        if (headers[group] != bp)
+            check_report(lineno, bp, "free block missing from its class list");
+    } else if (!in_heap(pred) || GET_ALLOC(HDRP(pred)) || GET_SUCC(pred) != bp) {
+        check_report(lineno, bp, "pred link is broken");
+    } else if (size_to_group(GET_SIZE(HDRP(pred))) != group) {
+        check_report(lineno, bp, "free block linked into the wrong class");
+    }
+    if (succ != NULL && (!in_heap(succ) || GET_ALLOC(HDRP(succ)) || GET_PRED(succ) != bp))
+        check_report(lineno, bp, "succ link is broken");
+}
+
 void mm_checkheap(int lineno)
 {
-  /* 예: 경계/정렬/헤더-풋터 일치, 인접한 free의 중복 여부, free 리스트 노드 검증 등 */
-  (void)lineno;
+    char *bp;
+    size_t heap_free = 0, list_free = 0;
+
+    if (GET(HDRP(pPrologueData)) != PACK(DSIZE, 1) || GET(FTRP(pPrologueData)) != PACK(DSIZE, 1))
+        check_report(lineno, pPrologueData, "bad prologue");
+
+    for (bp = NEXT_BLKP(pPrologueData); GET_SIZE(HDRP(bp)) != 0; bp = NEXT_BLKP(bp)) {
+        check_block(bp, lineno);
+        if (!GET_ALLOC(HDRP(bp))) heap_free++;
+        if (GET_SIZE(HDRP(bp)) < MIN_FREE_BLK) return;   /* 더 걸으면 위험 */
+    }
+    if (!GET_ALLOC(HDRP(bp)) || HDRP(bp) != (char *)mem_heap_hi() + 1 - WSIZE)
+        check_report(lineno, bp, "bad epilogue");
+
+    for (int group = 0; group < NLISTS; group++) {
+        for (bp = headers[group]; bp != NULL; bp = GET_SUCC(bp)) {
+            if (!in_heap(bp) || GET_ALLOC(HDRP(bp))) {
+                check_report(lineno, bp, "class list holds a non-free block");
+                break;
+            }
+            if (size_to_group(GET_SIZE(HDRP(bp))) != group)
+                check_report(lineno, bp, "free block linked into the wrong class");
+            if (++list_free > heap_free) {
+                check_report(lineno, bp, "class lists hold more nodes than free blocks (cycle?)");
+                return;
+            }
+        }
+    }
+    if (list_free != heap_free)
+        check_report(lineno, NULL, "free block count differs from class list node count");
+
+    for (int i = 0; i < EXACT_SLOTS; i++) {
+        exact_slot_t *slot = &exactIndex[i];
+        if (slot->size == 0)
+            continue;
+        if (!in_heap(slot->rep) || GET_ALLOC(HDRP(slot->rep)) || GET_SIZE(HDRP(slot->rep)) != slot->size)
+            check_report(lineno, slot->rep, "exact-size index points at a wrong block");
+        else if (exact_find(slot->size) != slot)
+            check_report(lineno, slot->rep, "exact-size index slot unreachable by probing");
+    }
+}
+
+/* 커서를 budget 블록만큼 전진시키며 검사; 에필로그에 닿으면 처음으로 되돌리고 멈춤 */
+static void check_step(int lineno)
+{
+    for (int n = 0; n < check_budget; n++) {
+        if (check_cursor == NULL)
+            check_cursor = NEXT_BLKP(pPrologueData);
+        if (GET_SIZE(HDRP(check_cursor)) == 0) {
+            check_cursor = NULL;
+            return;
+        }
+        check_block(check_cursor, lineno);
+        if (GET_SIZE(HDRP(check_cursor)) < MIN_FREE_BLK) { check_cursor = NULL; return; }
+        check_cursor = NEXT_BLKP(check_cursor);
+    }
+}
+
+/* 블록 gone이 survivor에 흡수될 때 커서가 사라지는 블록을 가리키지 않게 함 */
+static void check_forget(void *gone, void *survivor)
+{
+    if (check_cursor == gone) check_cursor = survivor;
+}
+
+/*
+ * mm_check_set_budget - examine nblocks blocks on every mm_malloc, mm_free
+ *     and mm_realloc call (0 turns the incremental checker off)
+ */
+void mm_check_set_budget(int nblocks)
+{
+    check_budget = nblocks > 0 ? nblocks : 0;
+}
+
+/* mm_check_errors - number of problems found since the last mm_init */
+int mm_check_errors(void)
+{
+    return check_errors;
+}
+
+/*
+ * Fragmentation breakdown
+ *
+ * 요청 크기는 호출자만 알고 블록 크기는 mm만 알기 때문에 두 단계로 나눈다:
+ * 호출자가 살아 있는 블록마다 mm_frag_block(ptr, 요청 크기)을 부르면 블록의
+ * 내부 낭비를 나눠 담고, 마지막에 mm_frag_heap이 힙을 한 번 훑어 나머지
+ * (free 블록, 꼬리, 건네지 않은 할당 블록)를 채운다.
+ */
+void mm_frag_block(void *ptr, size_t request, mm_frag_t *f)
+{
+    if (IS_NURSERY(ptr)) {
+        f->payload += request;
+        f->hdr_ftr += NURSERY_HDR;
+        f->align += NURSERY_SIZE(ptr) - NURSERY_HDR - request;
+        return;
+    }
+
+    size_t blockSize = GET_SIZE(HDRP(ptr));
+    size_t base = adjust_size(request);
+    size_t bumped = (request == 448) ? adjust_size(512) : (request == 112) ? adjust_size(128) : base;
+    size_t special = (blockSize >= bumped) ? bumped - base : 0;  /* realloc은 올리지 않음 */
+
+    f->payload += request;
+    f->hdr_ftr += 2 * WSIZE;
+    f->align += base - 2 * WSIZE - request;
+    f->special += special;
+    f->remainder += blockSize - base - special;
+}
+
+void mm_frag_heap(mm_frag_t *f)
+{
+    size_t live = f->payload + f->hdr_ftr + f->align + f->special + f->remainder;
+    size_t allocated = 0, freeBytes = 0, tail = getFreeSizeOfTail();
+    char *bp;
+
+    for (bp = NEXT_BLKP(pPrologueData); GET_SIZE(HDRP(bp)) != 0; bp = NEXT_BLKP(bp)) {
+        if (GET_ALLOC(HDRP(bp)))
+            allocated += GET_SIZE(HDRP(bp));
+        else
+            freeBytes += GET_SIZE(HDRP(bp));
+    }
+    f->external += freeBytes - tail;
+    f->tail += tail;
+    f->cached += allocated - live;
+    f->other += mem_heapsize() - allocated - freeBytes;
 }
 
 /* Map size → group index (대략 24,32,48,64,96,128,192,... 2배 근사) */
@@ -222,11 +562,46 @@ static int size_to_group(size_t size)
     return 15;                          /* 8193+ */
 }
 
+/* mm_init 이후의 연산 번호 (malloc + free + realloc 호출 수) */
+static uint64_t opnum_at_init;
+
+static uint64_t current_opnum(void)
+{
+    return MM_STAT_LOAD(n_malloc) + MM_STAT_LOAD(n_free) + MM_STAT_LOAD(n_realloc) - opnum_at_init;
+}
+
+/* 카운트다운이 끝난 할당을 표본으로 기록하고 헤더에 표시 */
+static void sample_block(void *bp, size_t size)
+{
+    if (mm_sample_record(bp, size, current_opnum()))
+        PUT(HDRP(bp), GET(HDRP(bp)) | SAMPLED);
+}
+
+/* realloc이 제자리에서 끝난 경우: 이전 표본은 죽이고 새 크기로 다시 카운트 */
+static void sample_resized(void *bp, size_t size, int wasSampled)
+{
+    if (wasSampled) {
+        mm_sample_release(bp);
+        PUT(HDRP(bp), GET(HDRP(bp)) & ~SAMPLED);
+    }
+    if (MM_SAMPLE_TICK(size)) sample_block(bp, size);
+}
+
 int mm_init(void)
 {
+    mm_stats_attach();
+    mm_stats_reset_gauges();
+    MM_STAT_ADD(n_init, 1);
+    mm_sample_reset();
+    opnum_at_init = 0;
+    opnum_at_init = current_opnum();
+
     /* 초기화: prologue(8B) + epilogue(4B) 프롤로그 설정 */
     if ((pPrologueData = mem_sbrk(4 * WSIZE)) == (void *)-1)
         return -1;
+    MM_STAT_ADD(heap_bytes, 4 * WSIZE);
+    committedBytes = 4 * WSIZE;
+    reclaimAt = limitSoft;
 
     PUT(pPrologueData, 0);                            /* alignment padding */
     PUT(pPrologueData + (1 * WSIZE), PACK(DSIZE, 1)); /* prologue header */
@@ -236,6 +611,19 @@ int mm_init(void)
 
     for (int i = 0; i < NLISTS; ++i)
         headers[i] = NULL;
+    memset(exactIndex, 0, sizeof(exactIndex));
+    exactUsed = 0;
+    memset(warmList, 0, sizeof(warmList));
+    memset(warmBatch, 0, sizeof(warmBatch));
+    warmMask = 0;
+    warmMissSize = 0;
+    warmMissRun = 0;
+    nurseryCur = nurserySpare = NULL;
+    reorderGroup = 0;
+    reorderPhase = RO_START;
+    reorderRun = reorderA = reorderB = NULL;
+    check_cursor = NULL;
+    check_errors = 0;
 
     /* 초기 부트스트랩: 첫 free 블록을 만들기 위해 CHUNKSIZE만큼 확장 */
     if (extend_heap(CHUNKSIZE / WSIZE) == NULL)
@@ -251,26 +639,97 @@ static void *extend_heap(size_t words)
 
     /* 8바이트 정렬 보장: 짝수 워드로 반올림 */
     size = (words % 2) ? (words + 1) * WSIZE : words * WSIZE;
+    if (!grow_allowed(size))
+        return NULL;
     if ((long)(bp = mem_sbrk(size)) == -1)
         return NULL;
+    committedBytes += size;
 
     PUT(HDRP(bp), PACK(size, 0));              /* free block header */
     PUT(FTRP(bp), PACK(size, 0));              /* free block footer */
     PUT(HDRP(NEXT_BLKP(bp)), PACK(0, 1));      /* new epilogue header */
+    MM_PROBE2(extend_heap, size, bp);
+    MM_STAT_ADD(n_extend, 1);
+    MM_STAT_ADD(extend_bytes, size);
+    MM_STAT_ADD(heap_bytes, size);
 
     return coalesce(bp);
 }
 
-/* Insert at head of segregated list */
+/*
+ * Exact-size index (linear probing)
+ *
+ * 슬롯의 rep는 항상 그 크기의 free 블록이다. 같은 크기 블록은 rep 바로 뒤에
+ * 삽입되므로 리스트에서 rep부터 연속이고, rep가 빠지면 succ가 같은 크기일 때
+ * 그것이 새 rep가 된다. 표가 EXACT_MAX_LOAD만큼 차면 새 크기는 색인하지 않고
+ * 예전처럼 리스트 머리에 넣는다 (find_fit의 스캔이 여전히 찾는다).
+ */
+static inline size_t exact_hash(size_t size)
+{
+    return ((size >> 3) * 0x9e3779b97f4a7c15ull) >> (64 - __builtin_ctz(EXACT_SLOTS));
+}
+
+/* size의 슬롯, 없으면 그 크기가 들어갈 빈 슬롯 */
+static exact_slot_t *exact_find(size_t size)
+{
+    size_t i = exact_hash(size);
+
+    while (exactIndex[i].size != 0 && exactIndex[i].size != size)
+        i = (i + 1) & (EXACT_SLOTS - 1);
+    return &exactIndex[i];
+}
+
+/* 슬롯 삭제: 뒤따르는 클러스터를 당겨 채워서 tombstone 없이 탐색을 유지 */
+static void exact_delete(exact_slot_t *slot)
+{
+    size_t hole = slot - exactIndex, i = hole;
+
+    for (;;) {
+        i = (i + 1) & (EXACT_SLOTS - 1);
+        if (exactIndex[i].size == 0)
+            break;
+        size_t home = exact_hash(exactIndex[i].size);
+        /* home이 (hole, i] 고리 구간 밖이면 hole로 옮겨도 탐색이 닿는다 */
+        if (((i - home) & (EXACT_SLOTS - 1)) >= ((i - hole) & (EXACT_SLOTS - 1))) {
+            exactIndex[hole] = exactIndex[i];
+            hole = i;
+        }
+    }
+    exactIndex[hole].size = 0;
+    exactIndex[hole].rep = NULL;
+    exactUsed--;
+}
+
+/* Insert into its segregated list: after the block of the same size, else at the head */
 static void insert_node(void *pJoiningNode)
 {
     size_t size = GET_SIZE(HDRP(pJoiningNode));
     int group = size_to_group(size);
+    exact_slot_t *slot = exact_find(size);
+
+    if (slot->size != 0) {
+        char *rep = slot->rep;
+        SET_PRED(pJoiningNode, rep);
+        SET_SUCC(pJoiningNode, GET_SUCC(rep));
+        if (GET_SUCC(rep) != NULL)
+            SET_PRED(GET_SUCC(rep), pJoiningNode);
+        SET_SUCC(rep, pJoiningNode);
+        MM_STAT_ADD(class_free_bytes[group], size);
+        MM_STAT_ADD(class_free_blocks[group], 1);
+        return;
+    }
+    if (exactUsed < EXACT_MAX_LOAD) {
+        slot->size = size;
+        slot->rep = pJoiningNode;
+        exactUsed++;
+    }
     SET_PRED(pJoiningNode, NULL);
     SET_SUCC(pJoiningNode, headers[group]);
     if (headers[group] != NULL)
         SET_PRED(headers[group], pJoiningNode);
     headers[group] = (char *)pJoiningNode;
+    MM_STAT_ADD(class_free_bytes[group], size);
+    MM_STAT_ADD(class_free_blocks[group], 1);
 }
 
 /* Remove from its segregated list */
@@ -281,6 +740,17 @@ static void remove_node(void *pTargetNode)
 
     char *pred = GET_PRED(pTargetNode);
     char *succ = GET_SUCC(pTargetNode);
+    exact_slot_t *slot = exact_find(size);
+
+    if (pTargetNode == reorderRun) reorderRun = succ;
+    if (pTargetNode == reorderA) reorderA = succ;
+    if (pTargetNode == reorderB) reorderB = succ;
+    if (slot->rep == pTargetNode) {
+        if (succ != NULL && GET_SIZE(HDRP(succ)) == size)
+            slot->rep = succ;
+        else
+            exact_delete(slot);
+    }
 
     if (pred != NULL)
         SET_SUCC(pred, succ);
@@ -289,6 +759,10 @@ static void remove_node(void *pTargetNode)
 
     if (succ != NULL)
         SET_PRED(succ, pred);
+    if (GET_DECOMMITTED(HDRP(pTargetNode)))
+        committedBytes += decommit_span(pTargetNode, size);   /* 떼어 낸 free 조각은 keep_decommitted가 다시 뺌 */
+    MM_STAT_SUB(class_free_bytes[group], size);
+    MM_STAT_SUB(class_free_blocks[group], 1);
 }
 
 static void *coalesce(void *bp)
@@ -296,8 +770,11 @@ static void *coalesce(void *bp)
     size_t prev_alloc = GET_ALLOC(FTRP(PREV_BLKP(bp)));
     size_t next_alloc = GET_ALLOC(HDRP(NEXT_BLKP(bp)));
     size_t size = GET_SIZE(HDRP(bp));
+    int decommitted = 0;
 
     if (!prev_alloc) {
+        decommitted |= GET_DECOMMITTED(HDRP(PREV_BLKP(bp)));
+        check_forget(bp, PREV_BLKP(bp));
         remove_node(PREV_BLKP(bp));
         size += GET_SIZE(HDRP(PREV_BLKP(bp)));
         PUT(FTRP(bp), PACK(size, 0));
@@ -306,16 +783,37 @@ static void *coalesce(void *bp)
     }
 
     if (!next_alloc) {
+        decommitted |= GET_DECOMMITTED(HDRP(NEXT_BLKP(bp)));
+        check_forget(NEXT_BLKP(bp), bp);
         remove_node(NEXT_BLKP(bp));
         size += GET_SIZE(HDRP(NEXT_BLKP(bp)));
         PUT(HDRP(bp), PACK(size, 0));
         PUT(FTRP(bp), PACK(size, 0));
     }
 
+    if (decommitted) {
+        /* 블록 하나에 반만 decommit된 상태는 표시할 수 없으므로 합친 블록을 통째로
+         * 다시 decommit: 병합 때문에 committed 바이트가 늘지 않는다 */
+        committedBytes -= mem_decommit((char *)bp + 2 * DSIZE, size - 2 * DSIZE - DSIZE);
+        PUT(HDRP(bp), PACK(size, DECOMMITTED));
+        PUT(FTRP(bp), PACK(size, DECOMMITTED));
+    }
     insert_node(bp);
+    MM_PROBE2(coalesce, bp, size);
     return bp;
 }
 
+/* payload 크기 → 헤더/풋터와 8B 정렬을 반영한 블록 크기 (최소 MIN_FREE_BLK) */
+static size_t adjust_size(size_t size)
+{
+    size_t adjustedSize;
+
+    if (size <= DSIZE) adjustedSize = 2 * DSIZE;
+    else adjustedSize = DSIZE * ((size + (DSIZE) + (DSIZE - 1)) / DSIZE);
+    if (adjustedSize < MIN_FREE_BLK) adjustedSize = MIN_FREE_BLK; /* MIN_FREE_BLK==24 */
+    return adjustedSize;
+}
+
 /* 힙 끝단(epilogue 바로 앞)의 free 블록 크기 반환, 없으면 0 */
 static size_t getFreeSizeOfTail(void)
 {
@@ -333,22 +831,77 @@ void *mm_malloc(size_t size)
     size_t adjustedSize;
     char *bp;
 
+    MM_PROBE1(malloc_entry, size);
+    if (check_budget) check_step(__LINE__);
     if (size == 0) return NULL;
-    else if (size == 448) size = 512;
-    else if (size == 112) size = 128;
+    MM_STAT_ADD(n_malloc, 1);
+    int line = alignLo && size >= alignLo && size <= alignHi;
+    if (size <= NURSERY_MAX && nurseryChunk && !line) {
+        /* nursery 객체도 표본 추출과 malloc_ret probe는 똑같이 거친다 */
+        if ((bp = nursery_alloc(size)) == NULL)
+            return NULL;
+        adjustedSize = IS_NURSERY(bp) ? NURSERY_SIZE(bp) : GET_SIZE(HDRP(bp));
+    } else {
+        if (size == 448) size = 512;
+        else if (size == 112) size = 128;
 
-    /* 헤더/풋터 및 정렬 반영한 유효 크기 계산 */
-    if (size <= DSIZE) adjustedSize = 2 * DSIZE;
-    else adjustedSize = DSIZE * ((size + (DSIZE) + (DSIZE - 1)) / DSIZE);
-    if (adjustedSize < MIN_FREE_BLK) adjustedSize = MIN_FREE_BLK; /* MIN_FREE_BLK==24 */
+        /* 헤더/풋터 및 정렬 반영한 유효 크기 계산 */
+        adjustedSize = adjust_size(size);
+        bp = line ? malloc_aligned(adjustedSize) : malloc_block(adjustedSize);
+        if (bp == NULL)
+            return NULL;
+    }
+    if (MM_SAMPLE_TICK(size)) sample_block(bp, size);
+    MM_PROBE2(malloc_ret, adjustedSize, bp);
+    return bp;
+}
 
-    /* 1) 기존 가용 블록에서 먼저 시도 */
-    if ((bp = find_fit(adjustedSize)) != NULL) {
-        place(bp, adjustedSize);
+/* 찾아 둔 free 블록 bp에 adjustedSize를 배치. decommit된 블록을 다시 쓰는 것은
+ * hard 한도 안에서만 (넘으면 NULL), 큰 블록은 -T 모드면 위쪽 끝에서 잘라 낸다 */
+static void *place_found(void *bp, size_t adjustedSize)
+{
+    if (!recommit_allowed(bp))
+        return NULL;
+    if (splitHigh && adjustedSize >= splitHigh)
+        return place_high(bp, adjustedSize);
+    place(bp, adjustedSize);
+    return bp;
+}
+
+/* adjustedSize 블록 하나를 할당 (warm 리스트 → find_fit → refill/확장 순) */
+static void *malloc_block(size_t adjustedSize)
+{
+    char *bp;
+
+    /* 0) 미리 쪼개 둔 같은 크기 블록 */
+    if (adjustedSize <= WARM_MAX && (bp = warmList[adjustedSize / DSIZE]) != NULL) {
+        if ((warmList[adjustedSize / DSIZE] = *(char **)bp) == NULL)
+            warmMask &= ~(1u << (adjustedSize / DSIZE));
+        MM_STAT_ADD(live_bytes, GET_SIZE(HDRP(bp)));
         return bp;
     }
 
-    /* 2) 끝단 free 블록의 부족분만 확장 (CHUNKSIZE 하한 없음) */
+    /* 1) 기존 가용 블록에서 먼저 시도 */
+    if ((bp = find_fit(adjustedSize)) != NULL)
+        return place_found(bp, adjustedSize);
+
+    /* 힙을 늘리기 전에 다른 크기의 warm 블록을 free로 돌려주고 다시 찾는다: burst가
+     * 끝난 크기의 남은 블록이 할당 상태로 영영 묶여 있지 않도록 (이 크기의 리스트는
+     * 0)에서 비어 있음을 보았으므로 진행 중인 burst의 것은 건드리지 않는다) */
+    if (warmMask != 0) {
+        warm_flush();
+        if ((bp = find_fit(adjustedSize)) != NULL)
+            return place_found(bp, adjustedSize);
+    }
+
+    /* 어차피 힙을 늘리는 느린 경로: 여기서 free 리스트 정렬을 조금 진행 */
+    if (reorderBudget) mm_reorder_step(reorderBudget);
+
+    /* 2) 같은 작은 크기의 burst: 한 번 확장해서 batch로 쪼갬 */
+    if (warm_burst(adjustedSize) && adjustedSize <= WARM_MAX)
+        return refill(adjustedSize);
+
+    /* 3) 끝단 free 블록의 부족분만 확장 (CHUNKSIZE 하한 없음) */
     // size_t lackingSize = (adjustedSize > CHUNKSIZE) ? adjustedSize : CHUNKSIZE; // coalescing-bal.rep not considered ❌
     size_t freeSizeOfTail = getFreeSizeOfTail();                 /* 없으면 0 */ // coalescing-bal.rep considered ✅
     size_t lackingSize = (adjustedSize > freeSizeOfTail) ? (adjustedSize - freeSizeOfTail) : 0; // coalescing-bal.rep considered ✅
@@ -359,41 +912,300 @@ void *mm_malloc(size_t size)
             return NULL;
     }
 
-    /* 3) 확장/병합 이후엔 반드시 적합 블록이 존재해야 함 */
-    bp = find_fit(adjustedSize);
-    place(bp, adjustedSize);
+    /* 4) 확장/병합 이후엔 반드시 적합 블록이 존재해야 함 (decommit된 꼬리와 합쳐졌을 수 있음) */
+    return place_found(find_fit(adjustedSize), adjustedSize);
+}
+
+/*
+ * Cache-line placement
+ *
+ * payload가 LINE_SIZE 경계에 오도록 free 블록 안에서 앞을 pad만큼 건너뛴다. pad가
+ * 0이 아니면 MIN_FREE_BLK 이상이 되도록 한 줄씩 늘려서, 건너뛴 앞부분을 그대로
+ * free 블록으로 리스트에 돌려준다 (앞 블록은 할당 상태이므로 병합할 것이 없음).
+ * 뒤쪽 자투리는 place와 똑같이 분할된다. 블록을 풀면 앞의 pad 블록과 병합되므로
+ * 패딩은 영구적으로 남지 않는다.
+ */
+static size_t line_pad(const char *bp)
+{
+    size_t pad = (size_t)(-(uintptr_t)bp) & (LINE_SIZE - 1);
+
+    while (pad != 0 && pad < MIN_FREE_BLK)
+        pad += LINE_SIZE;
+    return pad;
+}
+
+/* 정렬된 payload를 가진 adjustedSize 블록 하나를 할당 (warm 리스트는 쓰지 않음).
+ * 블록 크기를 줄 단위로 올려서 뒤 블록도 정렬된 채로 시작하게 한다: 연달아 오는
+ * 정렬 요청은 pad 없이 줄을 빈틈없이 채우고, pad 블록은 정렬이 어긋난 free 블록을
+ * 쓸 때만 생긴다 (pad가 요청마다 생기면 작은 class 리스트가 길어져 find_fit이 느려짐) */
+static void *malloc_aligned(size_t adjustedSize)
+{
+    char *bp;
+    size_t pad, capacity, decommitted;
+
+    adjustedSize = (adjustedSize + LINE_SIZE - 1) & ~(size_t)(LINE_SIZE - 1);
+    if ((bp = find_fit_aligned(adjustedSize)) == NULL) {
+        /* 꼬리 free 블록(없으면 새로 붙을 블록)에서 pad까지 감안해 모자란 만큼만 확장.
+         * extend_heap의 회수(reclaim)가 꼬리에 블록을 병합해 시작점을 앞당길 수 있으므로
+         * 확장한 뒤에는 bp와 pad를 다시 구해 맞는지 본다 */
+        for (;;) {
+            size_t tail = getFreeSizeOfTail();
+            bp = (char *)mem_heap_hi() + 1 - tail;
+            size_t need = line_pad(bp) + adjustedSize;
+            if (need <= tail)
+                break;
+            if (extend_heap((need - tail + (WSIZE - 1)) / WSIZE) == NULL)
+                return NULL;
+        }
+    }
+    if (!recommit_allowed(bp))
+        return NULL;
+
+    capacity = GET_SIZE(HDRP(bp));
+    decommitted = GET_DECOMMITTED(HDRP(bp));
+    pad = line_pad(bp);
+    remove_node(bp);
+    if (pad != 0) {
+        PUT(HDRP(bp), PACK(pad, 0));
+        PUT(FTRP(bp), PACK(pad, 0));
+        if (decommitted) keep_decommitted(bp);
+        insert_node(bp);
+        bp += pad;
+        capacity -= pad;
+        PUT(HDRP(bp), PACK(capacity, decommitted));   /* carve가 뒤쪽 자투리에 이어 줌 */
+        PUT(FTRP(bp), PACK(capacity, decommitted));
+    }
+    carve(bp, adjustedSize);
+    return bp;
+}
+
+/*
+ * mm_align_set - place payloads of lo..hi bytes on LINE_SIZE boundaries so
+ *     medium objects do not straddle cache lines; lo == 0 turns it off.
+ *     Such requests bypass the nursery and the warm lists.
+ */
+void mm_align_set(size_t lo, size_t hi)
+{
+    alignLo = lo;
+    alignHi = lo ? MAX(lo, hi) : 0;
+}
+
+/*
+ * Nursery
+ *
+ * nursery가 켜져 있으면 NURSERY_MAX 이하 요청은 chunk(보통의 할당 블록 하나)
+ * 안에서 bump 포인터로 할당한다. 객체 헤더는 8바이트: [크기][chunk 내 오프셋 | NURSERY | SAMPLED | 1]
+ * (SAMPLED는 보통 블록과 같은 bit1이라 표본 추출과 probe는 mm_malloc에서 똑같이 거친다).
+ * chunk는 살아 있는 객체 수만 세고, 0이 되면 통째로 재활용한다 (현재 chunk면
+ * bump를 처음으로 되돌리고, 아니면 예비 chunk로 두거나 힙에 돌려준다).
+ * 살아남은 객체는 움직이지 않으므로 그 chunk는 마지막 객체가 죽을 때까지 남는다.
+ * 객체 헤더는 chunk 블록 안쪽에 있어서 힙을 블록 단위로 훑는 코드에는 보이지 않는다.
+ */
+static nursery_chunk_t *nursery_new_chunk(void)
+{
+    nursery_chunk_t *c;
+    size_t asize = adjust_size(nurseryChunk);
+
+    if (nurserySpare != NULL) {
+        c = nurserySpare;
+        nurserySpare = NULL;
+        return c;
+    }
+    if ((c = malloc_block(asize)) == NULL)
+        return NULL;
+    c->live = 0;
+    c->start = c->bump = (char *)c + ALIGN(sizeof(nursery_chunk_t));
+    c->end = (char *)c + GET_SIZE(HDRP(c)) - DSIZE;
+    return c;
+}
+
+/* 객체가 하나도 없는 chunk: 예비로 하나 남기고 나머지는 힙에 돌려준다 */
+static void nursery_retire(nursery_chunk_t *c)
+{
+    c->bump = c->start;
+    if (nurserySpare == NULL) {
+        nurserySpare = c;
+        return;
+    }
+    MM_STAT_SUB(live_bytes, GET_SIZE(HDRP(c)));
+    release_block(c);
+}
+
+static void *nursery_alloc(size_t size)
+{
+    size_t osize = ALIGN(size) + NURSERY_HDR;
+    nursery_chunk_t *c = nurseryCur;
+    char *obj;
+
+    if (c == NULL || c->bump + osize > c->end) {
+        if ((c = nursery_new_chunk()) == NULL)
+            return NULL;
+        if (c->bump + osize > c->end) {
+            /* mm_nursery_set이 크기를 맞추므로 일어나지 않아야 하지만, 넘치게 쓰지 않고 보통 블록으로 */
+            nursery_retire(c);
+            return malloc_block(adjust_size(size));
+        }
+        if (nurseryCur != NULL && nurseryCur->live == 0)
+            nursery_retire(nurseryCur);
+        nurseryCur = c;
+    }
+    obj = c->bump + NURSERY_HDR;
+    c->bump += osize;
+    c->live++;
+    NURSERY_SIZE(obj) = osize;
+    PUT(HDRP(obj), (unsigned int)((obj - (char *)c) << 3) | NURSERY | 1);
+    return obj;
+}
+
+static void nursery_free(void *bp)
+{
+    nursery_chunk_t *c = NURSERY_CHUNK(bp);
+
+    PUT(HDRP(bp), 0);   /* 이중 free를 잡기 쉽게 */
+    if (--c->live == 0) {
+        if (c == nurseryCur)
+            c->bump = c->start;   /* 현재 chunk: 처음부터 다시 */
+        else
+            nursery_retire(c);
+    }
+}
+
+/* 쥐고 있는 빈 chunk를 힙에 돌려준다 (heap budget 회수, 모드 변경) */
+static void nursery_flush(void)
+{
+    nursery_chunk_t *spare = nurserySpare;
+
+    nurserySpare = NULL;
+    if (nurseryCur != NULL && nurseryCur->live == 0) {
+        MM_STAT_SUB(live_bytes, GET_SIZE(HDRP(nurseryCur)));
+        release_block(nurseryCur);
+        nurseryCur = NULL;
+    }
+    if (spare != NULL) {
+        MM_STAT_SUB(live_bytes, GET_SIZE(HDRP(spare)));
+        release_block(spare);
+    }
+}
+
+/*
+ * mm_nursery_set - bump-allocate requests of at most NURSERY_MAX bytes from
+ *     chunk_bytes chunks; 0 turns the nursery off for new allocations
+ *     (objects already in chunks are still freed normally). Other sizes are
+ *     clamped to [NURSERY_CHUNK_MIN, NURSERY_CHUNK_MAX].
+ */
+void mm_nursery_set(size_t chunk_bytes)
+{
+    if (chunk_bytes != 0)
+        chunk_bytes = MIN(MAX(chunk_bytes, NURSERY_CHUNK_MIN), NURSERY_CHUNK_MAX);
+    nursery_flush();
+    if (nurseryCur != NULL && chunk_bytes != nurseryChunk)
+        nurseryCur = NULL;   /* 살아 있는 객체가 있는 chunk는 그대로 둠: 마지막 free가 retire */
+    nurseryChunk = chunk_bytes;
+}
+
+/*
+ * mm_malloc_near - like mm_malloc, but prefer a free block within NEAR_REGION
+ *     bytes of hint (e.g. the previous node of a list being built), so linked
+ *     structures stay within the same pages and cache sets. Falls back to
+ *     mm_malloc when nothing nearby fits.
+ */
+void *mm_malloc_near(void *hint, size_t size)
+{
+    size_t request = size, adjustedSize;
+    char *bp;
+
+    if (hint == NULL || !in_heap(hint) || size == 0) return mm_malloc(size);
+    /* nursery와 줄 정렬 대상은 mm_malloc의 경로를 그대로 탄다 */
+    if ((size <= NURSERY_MAX && nurseryChunk) ||
+        (alignLo && size >= alignLo && size <= alignHi))
+        return mm_malloc(size);
+    if (size == 448) size = 512;
+    else if (size == 112) size = 128;
+
+    adjustedSize = adjust_size(size);
+    if ((adjustedSize <= WARM_MAX && warmList[adjustedSize / DSIZE] != NULL) ||
+        (bp = find_fit_near(adjustedSize, hint)) == NULL)
+        return mm_malloc(request);
+
+    /* 여기서부터는 되돌아가지 않으므로 probe와 검사는 한 번만 */
+    MM_PROBE1(malloc_entry, request);
+    if (check_budget) check_step(__LINE__);
+    MM_STAT_ADD(n_malloc, 1);
+    if ((bp = place_found(bp, adjustedSize)) == NULL)
+        return NULL;
+    if (MM_SAMPLE_TICK(size)) sample_block(bp, size);
+    MM_PROBE2(malloc_ret, adjustedSize, bp);
     return bp;
 }
 
 void mm_free(void *bp)
 {
     if (bp == NULL) return;
+    if (check_budget) check_step(__LINE__);
+    MM_STAT_ADD(n_free, 1);
+    if (IS_NURSERY(bp)) {
+        MM_PROBE2(free, bp, NURSERY_SIZE(bp));
+        if (GET_SAMPLED(HDRP(bp))) mm_sample_release(bp);
+        nursery_free(bp);
+        return;
+    }
 
     size_t size = GET_SIZE(HDRP(bp));
+    MM_PROBE2(free, bp, size);
+    MM_STAT_SUB(live_bytes, size);
+    if (GET_SAMPLED(HDRP(bp))) mm_sample_release(bp);
+    release_block(bp);
+}
+
+/* 할당 블록을 free로 바꾸고 병합 */
+static void release_block(void *bp)
+{
+    size_t size = GET_SIZE(HDRP(bp));
+
     PUT(HDRP(bp), PACK(size, 0));
     PUT(FTRP(bp), PACK(size, 0));
 
     SET_PRED(bp, NULL);
     SET_SUCC(bp, NULL);
 
-    coalesce(bp);
+    bp = coalesce(bp);
+    if (limitSoft && committedBytes > limitSoft && GET_SIZE(HDRP(NEXT_BLKP(bp))) == 0)
+        trim_tail();   /* 꼬리가 비었으니 soft 아래로 내려갈 기회 */
 }
 
 void *mm_realloc(void *bp, size_t size)
 {
+    MM_PROBE2(realloc_entry, bp, size);
     if (bp == NULL) return mm_malloc(size);
     if (size == 0) { mm_free(bp); return NULL; }
+    if (check_budget) check_step(__LINE__);
+    MM_STAT_ADD(n_realloc, 1);
+
+    if (IS_NURSERY(bp)) {
+        /* nursery 객체는 제자리에서 늘릴 수 없음: 맞으면 그대로, 아니면 이동 */
+        size_t payload = NURSERY_SIZE(bp) - NURSERY_HDR;
+        if (size <= payload) {
+            sample_resized(bp, size, GET_SAMPLED(HDRP(bp)));
+            MM_PROBE3(realloc_ret, bp, size, bp);
+            return bp;
+        }
+        void *pDestination = mm_malloc(size);
+        if (pDestination == NULL) return NULL;
+        memcpy(pDestination, bp, payload);
+        mm_free(bp);
+        MM_PROBE3(realloc_ret, bp, size, pDestination);
+        return pDestination;
+    }
 
     size_t outdatedSize = GET_SIZE(HDRP(bp));
-    size_t adjustedSize;
-    if (size <= DSIZE) adjustedSize = 2 * DSIZE;
-    else adjustedSize = DSIZE * ((size + (DSIZE) + (DSIZE - 1)) / DSIZE);
-    if (adjustedSize < MIN_FREE_BLK) adjustedSize = MIN_FREE_BLK;
+    int wasSampled = GET_SAMPLED(HDRP(bp));
+    size_t adjustedSize = adjust_size(size);
 
     /* 축소 혹은 자투리 분할 */
     if (adjustedSize <= outdatedSize) {
         size_t sizeOfRightPiece = outdatedSize - adjustedSize;
         if (sizeOfRightPiece >= MIN_FREE_BLK) {
+            MM_STAT_SUB(live_bytes, sizeOfRightPiece);
             PUT(HDRP(bp), PACK(adjustedSize, 1));
             PUT(FTRP(bp), PACK(adjustedSize, 1));
             void *nbp = NEXT_BLKP(bp);
@@ -403,21 +1215,27 @@ void *mm_realloc(void *bp, size_t size)
             SET_SUCC(nbp, NULL);
             coalesce(nbp);
         }
+        sample_resized(bp, size, wasSampled);
+        MM_PROBE3(realloc_ret, bp, size, bp);
         return bp;
     }
 
-    /* 우측 인접 free와 병합해 확장 시도 */
+    /* 우측 인접 free와 병합해 확장 시도 (decommit된 이웃은 hard 한도 안일 때만) */
     void *pRightAdjacent = NEXT_BLKP(bp);
     if (!GET_ALLOC(HDRP(pRightAdjacent))) {
         size_t capacity = outdatedSize + GET_SIZE(HDRP(pRightAdjacent));
-        if (capacity >= adjustedSize) {
+        if (capacity >= adjustedSize && recommit_allowed(pRightAdjacent)) {
+            int decommitted = GET_DECOMMITTED(HDRP(pRightAdjacent));
+            check_forget(pRightAdjacent, bp);
             remove_node(pRightAdjacent);
 
             size_t sizeOfRightPart = capacity - adjustedSize;
             PUT(HDRP(bp), PACK(capacity, 1));
             PUT(FTRP(bp), PACK(capacity, 1));
+            MM_STAT_ADD(live_bytes, capacity - outdatedSize);
 
             if (sizeOfRightPart >= MIN_FREE_BLK) {
+                MM_STAT_SUB(live_bytes, sizeOfRightPart);
                 PUT(HDRP(bp), PACK(adjustedSize, 1));
                 PUT(FTRP(bp), PACK(adjustedSize, 1));
                 void *nbp = NEXT_BLKP(bp);
@@ -425,23 +1243,287 @@ void *mm_realloc(void *bp, size_t size)
                 PUT(FTRP(nbp), PACK(sizeOfRightPart, 0));
                 SET_PRED(nbp, NULL);
                 SET_SUCC(nbp, NULL);
+                if (decommitted) keep_decommitted(nbp);
                 insert_node(nbp);
             }
+            sample_resized(bp, size, wasSampled);
+            MM_PROBE3(realloc_ret, bp, size, bp);
             return bp;
         }
     }
 
-    /* 새로 할당 후 복사 */
+    /* 새로 할당 후 복사. 자라는 블록은 위쪽 이웃이 비어 있어야 다음에 제자리에서
+     * 늘 수 있으므로 양끝 배치 모드에서도 아래쪽 끝에 놓는다 */
+    size_t savedSplit = splitHigh;
+    splitHigh = 0;
     void *pDestination = mm_malloc(size);
+    splitHigh = savedSplit;
     if (pDestination == NULL) return NULL;
 
     size_t sizeOfPayload = outdatedSize - DSIZE; /* payload = block size - hdr(4) - ftr(4) */
     if (size < sizeOfPayload) sizeOfPayload = size;
-    memcpy(pDestination, bp, sizeOfPayload);
+    copy_payload(pDestination, bp, sizeOfPayload);
     mm_free(bp);
+    MM_PROBE3(realloc_ret, bp, size, pDestination);
     return pDestination;
 }
 
+/*
+ * mm_usable_size - bytes the caller may use at ptr: at least what was
+ *     requested, plus the 8-byte rounding and any remainder place() or
+ *     realloc did not split off. Growing within it needs no mm_realloc.
+ */
+size_t mm_usable_size(void *ptr)
+{
+    if (ptr == NULL) return 0;
+    if (IS_NURSERY(ptr))
+        return NURSERY_SIZE(ptr) - NURSERY_HDR;
+    return GET_SIZE(HDRP(ptr)) - DSIZE;   /* 헤더(4) + 풋터(4) */
+}
+
+/*
+ * Reserved buffers
+ *
+ * 최종 크기를 모르는 큰 버퍼(로그, 배열)는 realloc으로 키우면 언젠가는 이동과
+ * 복사가 생긴다. mm_reserve는 힙 밖에 max_bytes만큼 주소 공간만 예약하고
+ * (mem_map_reserve), mm_grow는 필요한 페이지를 commit할 뿐 블록을 옮기지 않는다.
+ * 예약 범위 안이면 실패하지 않고, 넘으면 -1을 돌려줄 뿐 이동으로 대신하지 않는다.
+ *
+ * commit은 필요한 크기와 지금의 두 배 중 큰 쪽까지 한 번에 한다: 물리 페이지는
+ * 처음 건드릴 때 생기므로 미리 commit해도 메모리 비용은 없고 mprotect 호출만 준다.
+ * 매핑 첫머리의 reserve_hdr_t가 크기를 기억한다. 이 블록은 힙 블록이 아니므로
+ * mm_free/mm_realloc/mm_usable_size 대신 mm_release로 돌려주고, 힙 한도
+ * (mm_heap_set_limit)와 mm_init의 초기화와도 무관하다.
+ */
+typedef struct {
+    size_t reserved;                   /* payload로 쓸 수 있는 최대 바이트 */
+    size_t committed;                  /* 그 중 지금 commit된 바이트 */
+} reserve_hdr_t;
+
+#define RESERVE_HDR     (2 * DSIZE)   /* sizeof(reserve_hdr_t), payload 정렬 유지 */
+#define RESERVE_HDRP(p) ((reserve_hdr_t *)((char *)(p) - RESERVE_HDR))
+
+/*
+ * mm_reserve - reserve room for a buffer of up to max_bytes that can later
+ *     grow in place with mm_grow; only the first page is committed. Returns
+ *     NULL if the address space cannot be reserved.
+ */
+void *mm_reserve(size_t max_bytes)
+{
+    size_t pagesize = mem_pagesize();
+    size_t total = (RESERVE_HDR + max_bytes + pagesize - 1) & ~(pagesize - 1);
+    char *base;
+
+    if (max_bytes == 0 || (base = mem_map_reserve(total)) == NULL)
+        return NULL;
+    if (mem_map_commit(base, pagesize) != 0) {
+        mem_map_release(base, total);
+        return NULL;
+    }
+    ((reserve_hdr_t *)base)->reserved = total - RESERVE_HDR;
+    ((reserve_hdr_t *)base)->committed = pagesize - RESERVE_HDR;
+    return base + RESERVE_HDR;
+}
+
+/*
+ * mm_grow - make the first new_size bytes of a reserved buffer usable.
+ *     The buffer never moves: returns 0, or -1 if new_size is beyond the
+ *     reservation or the pages cannot be committed.
+ */
+int mm_grow(void *ptr, size_t new_size)
+{
+    reserve_hdr_t *h = RESERVE_HDRP(ptr);
+    size_t pagesize = mem_pagesize();
+    size_t want;
+
+    if (new_size <= h->committed)
+        return 0;
+    if (new_size > h->reserved)
+        return -1;
+    want = MIN(MAX(new_size, 2 * h->committed), h->reserved);
+    want = ((RESERVE_HDR + want + pagesize - 1) & ~(pagesize - 1)) - RESERVE_HDR;
+    if (mem_map_commit((char *)ptr + h->committed, want - h->committed) != 0)
+        return -1;
+    h->committed = want;
+    return 0;
+}
+
+/* mm_release - unmap a buffer from mm_reserve (NULL is ignored) */
+void mm_release(void *ptr)
+{
+    if (ptr == NULL) return;
+    mem_map_release(RESERVE_HDRP(ptr), RESERVE_HDR + RESERVE_HDRP(ptr)->reserved);
+}
+
+/*
+ * copy_payload - realloc 이동용 복사
+ *   작은 payload는 libc memcpy(이미 크기별로 튜닝됨). ntCopyThreshold 이상이면
+ *   목적지를 16B 정렬한 뒤 _mm_stream_si128로 캐시를 거치지 않고 쓰고, 원본은
+ *   NTA prefetch로 읽어서 애플리케이션의 working set을 밀어내지 않는다.
+ */
+static void copy_payload(void *dst, const void *src, size_t n)
+{
+#if defined(__SSE2__)
+    if (n >= ntCopyThreshold) {
+        char *d = (char *)dst;
+        const char *s = (const char *)src;
+        size_t head = (16 - ((uintptr_t)d & 15)) & 15;
+
+        memcpy(d, s, head);
+        d += head; s += head; n -= head;
+        for (; n >= 64; n -= 64, d += 64, s += 64) {
+            _mm_prefetch(s + 512, _MM_HINT_NTA);
+            __m128i x0 = _mm_loadu_si128((const __m128i *)s);
+            __m128i x1 = _mm_loadu_si128((const __m128i *)(s + 16));
+            __m128i x2 = _mm_loadu_si128((const __m128i *)(s + 32));
+            __m128i x3 = _mm_loadu_si128((const __m128i *)(s + 48));
+            _mm_stream_si128((__m128i *)d, x0);
+            _mm_stream_si128((__m128i *)(d + 16), x1);
+            _mm_stream_si128((__m128i *)(d + 32), x2);
+            _mm_stream_si128((__m128i *)(d + 48), x3);
+        }
+        _mm_sfence();   /* streaming store는 약한 순서: 이후 읽기 전에 정렬 */
+        memcpy(d, s, n);
+        return;
+    }
+#endif
+    memcpy(dst, src, n);
+}
+
+/*
+ * Heap budget
+ *
+ * committedBytes는 extend_heap(+), 꼬리 반납(-), decommit(-), decommit된 블록이
+ * 리스트에서 빠질 때(+)만 바뀌므로 연산당 O(1)이다. DECOMMITTED 표시는 블록이
+ * 실제로 할당될 때만 풀린다: 쪼개고 남은 조각은 표시를 물려받고(keep_decommitted),
+ * 병합된 블록은 통째로 다시 decommit한다. 회수는 soft를 넘을 때만 돈다:
+ * 꼬리 free 블록을 memlib에 돌려주고, 한 페이지 이상 걸친 free 블록의 내부
+ * 페이지를 decommit 한다. 그 전에 warm 리스트와 빈 nursery chunk를 비워서
+ * 그 블록들도 병합·반납 대상이 되게 한다. 그래도 soft 위라면 soft/8 더 자랄 때까지
+ * 다시 돌지 않는다 (확장마다 리스트를 훑지 않도록).
+ */
+
+/* free 블록에서 decommit할 수 있는 바이트: pred/succ 뒤부터 footer 앞까지의 온전한 페이지 */
+static size_t decommit_span(void *bp, size_t size)
+{
+    size_t pagesize = mem_pagesize();
+    uintptr_t lo = ((uintptr_t)bp + 2 * DSIZE + pagesize - 1) & ~(pagesize - 1);
+    uintptr_t hi = (uintptr_t)FTRP(bp) & ~(pagesize - 1);
+    (void)size;
+    return (hi > lo) ? hi - lo : 0;
+}
+
+/* decommit된 free 블록 bp를 다시 써도 hard 한도 안인지 (remove_node가 페이지를 되돌려 셈) */
+static int recommit_allowed(void *bp)
+{
+    return !limitHard || !GET_DECOMMITTED(HDRP(bp)) ||
+           committedBytes + decommit_span(bp, GET_SIZE(HDRP(bp))) <= limitHard;
+}
+
+/* decommit된 블록을 쪼개고 남은 free 조각 bp: 그 안쪽 페이지는 아직 반납된 채이므로
+ * (헤더와 pred/succ만 썼음) 표시를 되살리고 remove_node가 더한 몫을 다시 뺀다 */
+static void keep_decommitted(void *bp)
+{
+    size_t span = decommit_span(bp, GET_SIZE(HDRP(bp)));
+
+    if (span == 0)
+        return;
+    committedBytes -= span;
+    PUT(HDRP(bp), GET(HDRP(bp)) | DECOMMITTED);
+    PUT(FTRP(bp), GET(FTRP(bp)) | DECOMMITTED);
+}
+
+/* bytes만큼 힙을 늘려도 되는지; soft를 넘게 되면 먼저 회수
+ * (mm_malloc이 꼬리 크기를 보고 확장량을 정했으므로 여기서는 꼬리를 반납하지 않음) */
+static int grow_allowed(size_t bytes)
+{
+    if (limitSoft && committedBytes + bytes > reclaimAt) {
+        reclaim(0);
+        reclaimAt = MAX(committedBytes + bytes, limitSoft) + MAX(limitSoft / 8, CHUNKSIZE);
+    }
+    return !limitHard || committedBytes + bytes <= limitHard;
+}
+
+/* 꼬리 free 블록을 통째로 memlib에 반납: 그 자리가 새 에필로그 (O(1)) */
+static void trim_tail(void)
+{
+    size_t tail = getFreeSizeOfTail();
+    char *bp = (char *)mem_heap_hi() + 1 - tail;
+
+    if (tail < CHUNKSIZE)
+        return;
+    check_forget(bp, NULL);
+    remove_node(bp);
+    PUT(HDRP(bp), PACK(0, 1));
+    mem_shrink(tail);
+    committedBytes -= tail;
+    MM_STAT_SUB(heap_bytes, tail);
+}
+
+static void reclaim(int trim)
+{
+    warm_flush();
+    nursery_flush();
+    if (trim)
+        trim_tail();
+
+    /* 페이지 하나 이상 걸칠 수 있는 group만 훑어 내부 페이지 decommit */
+    for (int group = size_to_group(mem_pagesize()); group < NLISTS; group++) {
+        for (char *bp = headers[group]; bp != NULL; bp = GET_SUCC(bp)) {
+            size_t size = GET_SIZE(HDRP(bp));
+            if (GET_DECOMMITTED(HDRP(bp)) || decommit_span(bp, size) == 0)
+                continue;
+            committedBytes -= mem_decommit(bp + 2 * DSIZE, size - 2 * DSIZE - DSIZE);
+            PUT(HDRP(bp), GET(HDRP(bp)) | DECOMMITTED);
+            PUT(FTRP(bp), GET(FTRP(bp)) | DECOMMITTED);
+        }
+    }
+}
+
+/*
+ * mm_heap_set_limit - cap the heap's committed bytes. Past soft the heap is
+ *     trimmed and free pages are decommitted; an allocation that would need
+ *     to grow past hard returns NULL. 0 means no limit. Returns -1 if
+ *     soft > hard.
+ */
+int mm_heap_set_limit(size_t soft, size_t hard)
+{
+    if (soft && hard && soft > hard)
+        return -1;
+    limitSoft = soft;
+    limitHard = hard;
+    reclaimAt = soft;
+    if (soft && committedBytes > soft) {
+        reclaim(1);
+        reclaimAt = MAX(committedBytes, soft) + MAX(soft / 8, CHUNKSIZE);
+    }
+    return 0;
+}
+
+/* mm_heap_committed - bytes of the heap currently backed by memory */
+size_t mm_heap_committed(void)
+{
+    return committedBytes;
+}
+
+/*
+ * mm_copy_set_threshold - realloc moves of at least bytes use streaming
+ *     stores; (size_t)-1 always uses memcpy, 0 always streams.
+ */
+void mm_copy_set_threshold(size_t bytes)
+{
+    ntCopyThreshold = bytes;
+}
+
+/* find_fit 한 번의 탐색 길이를 통계에 반영 */
+static inline void search_done(size_t steps, int found)
+{
+    MM_STAT_ADD(n_search, 1);
+    MM_STAT_ADD(search_steps, steps);
+    MM_STAT_MAX(search_max, steps);
+    if (!found) MM_STAT_ADD(search_fail, 1);
+}
+
 /* Best-fit over segregated lists:
  * - 요청 크기의 group부터 위로 올라가며 모든 후보를 스캔
  * - waste(= 블록크기 - asize)가 가장 작은 블록을 선택
@@ -451,14 +1533,26 @@ static void *find_fit(size_t adjustedSize)
 {
     void *pBestFit = NULL;
     size_t bestAmountOfWaste = (size_t)-1;  /* 가장 작은 낭비를 추적 */
+    size_t steps = 0;
+    exact_slot_t *slot = exact_find(adjustedSize);
+
+    if (slot->size != 0) {
+        /* 완벽 일치가 색인에 있음: 스캔 생략 */
+        search_done(0, 1);
+        MM_PROBE2(find_fit, adjustedSize, slot->rep);
+        return slot->rep;
+    }
 
     for (int group = size_to_group(adjustedSize); group < NLISTS; ++group) {
         for (char *bp = headers[group]; bp != NULL; bp = GET_SUCC(bp)) {
             size_t capacity = GET_SIZE(HDRP(bp));
+            steps++;
             if (capacity >= adjustedSize) {
                 size_t temp = capacity - adjustedSize;
                 if (temp == 0) {
                     /* 완벽 일치: 더 볼 필요 없음 */
+                    search_done(steps, 1);
+                    MM_PROBE2(find_fit, adjustedSize, bp);
                     return bp;
                 }
                 if (temp < bestAmountOfWaste) {
@@ -469,19 +1563,87 @@ static void *find_fit(size_t adjustedSize)
         }
     }
 
+    search_done(steps, pBestFit != NULL);
+    MM_PROBE2(find_fit, adjustedSize, pBestFit);
     return pBestFit; /* 없으면 NULL */
 }
 
+/* find_fit과 같은 범위를 훑되, hint에서 NEAR_REGION 이내인 블록만 고려한다.
+ * 그 중 낭비가 가장 적은 블록, 낭비가 같으면 hint에 더 가까운 블록을 고른다.
+ * (class 리스트를 어차피 끝까지 보므로 주소별 버킷을 따로 두지 않는다) */
+static void *find_fit_near(size_t adjustedSize, char *hint)
+{
+    void *pBest = NULL;
+    size_t bestWaste = (size_t)-1, bestDistance = (size_t)-1;
+    size_t steps = 0;
+
+    for (int group = size_to_group(adjustedSize); group < NLISTS; ++group) {
+        for (char *bp = headers[group]; bp != NULL; bp = GET_SUCC(bp)) {
+            size_t capacity = GET_SIZE(HDRP(bp));
+            size_t distance = (bp > hint) ? (size_t)(bp - hint) : (size_t)(hint - bp);
+            steps++;
+            if (capacity < adjustedSize || distance > NEAR_REGION)
+                continue;
+            size_t waste = capacity - adjustedSize;
+            if (waste < bestWaste || (waste == bestWaste && distance < bestDistance)) {
+                bestWaste = waste;
+                bestDistance = distance;
+                pBest = bp;
+            }
+        }
+    }
+
+    search_done(steps, pBest != NULL);
+    MM_PROBE2(find_fit, adjustedSize, pBest);
+    return pBest;
+}
+
+/* 정렬 pad를 뺀 용량으로 보는 segregated fit: 후보가 나온 첫 group에서 멈추고,
+ * group마다 ALIGNED_SCAN 블록까지만 본다 (pad 블록이 쌓인 리스트를 매번 끝까지
+ * 훑지 않도록; 못 찾으면 꼬리에서 확장) */
+static void *find_fit_aligned(size_t adjustedSize)
+{
+    void *pBest = NULL;
+    size_t bestWaste = (size_t)-1;
+    size_t steps = 0;
+
+    for (int group = size_to_group(adjustedSize); group < NLISTS && pBest == NULL; ++group) {
+        int budget = ALIGNED_SCAN;
+        for (char *bp = headers[group]; bp != NULL && budget-- > 0; bp = GET_SUCC(bp)) {
+            size_t capacity = GET_SIZE(HDRP(bp));
+            size_t need = adjustedSize + line_pad(bp);
+            steps++;
+            if (capacity < need || capacity - need >= bestWaste)
+                continue;
+            bestWaste = capacity - need;
+            pBest = bp;
+            if (bestWaste == 0)
+                break;
+        }
+    }
+
+    search_done(steps, pBest != NULL);
+    MM_PROBE2(find_fit, adjustedSize, pBest);
+    return pBest;
+}
 
 static void place(void *bp, size_t adjustedSize)
 {
-    size_t capacity = GET_SIZE(HDRP(bp));
     remove_node(bp);
+    carve(bp, adjustedSize);
+}
+
+/* 리스트에서 빠진 free 블록 bp의 앞쪽 adjustedSize를 할당, 남는 뒤쪽은 free로 */
+static void carve(void *bp, size_t adjustedSize)
+{
+    size_t capacity = GET_SIZE(HDRP(bp));
+    int decommitted = GET_DECOMMITTED(HDRP(bp));
 
     if (capacity - adjustedSize >= MIN_FREE_BLK) {
         /* 앞쪽을 할당, 뒤쪽을 free로 분할 */
         PUT(HDRP(bp), PACK(adjustedSize, 1));
         PUT(FTRP(bp), PACK(adjustedSize, 1));
+        MM_STAT_ADD(live_bytes, adjustedSize);
 
         void *pRightPart = NEXT_BLKP(bp);
         size_t sizeOfRightPart = capacity - adjustedSize;
@@ -489,9 +1651,274 @@ static void place(void *bp, size_t adjustedSize)
         PUT(FTRP(pRightPart), PACK(sizeOfRightPart, 0));
         SET_PRED(pRightPart, NULL);
         SET_SUCC(pRightPart, NULL);
+        if (decommitted) keep_decommitted(pRightPart);
         insert_node(pRightPart);
     } else {
         PUT(HDRP(bp), PACK(capacity, 1));
         PUT(FTRP(bp), PACK(capacity, 1));
+        MM_STAT_ADD(live_bytes, capacity);
+    }
+}
+
+/*
+ * Two-ended placement
+ *
+ * 작은 블록과 큰 블록이 한 주소 흐름에 번갈아 놓이면, 큰 블록이 풀려도 사이사이
+ * 살아 있는 작은 블록 때문에 병합되지 못한다 (binary-bal.rep의 패턴). 그래서 큰
+ * 요청은 고른 free 블록의 위쪽 끝을 할당하고 아래쪽을 free로 남긴다. 작은 요청은
+ * 그대로 아래쪽부터 잘라 가므로, 같은 free 블록 안에서 두 종류가 양끝에서 자라
+ * 각자 자기 종류끼리 이웃하고 병합된다.
+ *
+ * 힙은 sbrk로 위로만 자라므로 따로 높은 영역을 두지 않는다: 큰 요청이 확장한
+ * 꼬리는 위쪽 끝에 큰 블록이 놓이고, 그것이 풀리면 꼬리 free 블록이 되어
+ * trim_tail이 예전처럼 반납한다. 고르는 블록(best fit)은 바뀌지 않는다.
+ */
+static void *place_high(void *bp, size_t adjustedSize)
+{
+    size_t capacity = GET_SIZE(HDRP(bp));
+    size_t sizeOfLeftPart = capacity - adjustedSize;
+
+    if (sizeOfLeftPart < MIN_FREE_BLK) {
+        place(bp, adjustedSize);
+        return bp;
+    }
+    int decommitted = GET_DECOMMITTED(HDRP(bp));
+    remove_node(bp);
+    PUT(HDRP(bp), PACK(sizeOfLeftPart, 0));
+    PUT(FTRP(bp), PACK(sizeOfLeftPart, 0));
+    SET_PRED(bp, NULL);
+    SET_SUCC(bp, NULL);
+    if (decommitted) keep_decommitted(bp);
+    insert_node(bp);                   /* 앞 블록은 할당 상태라 병합할 것 없음 */
+
+    bp = NEXT_BLKP(bp);
+    PUT(HDRP(bp), PACK(adjustedSize, 1));
+    PUT(FTRP(bp), PACK(adjustedSize, 1));
+    MM_STAT_ADD(live_bytes, adjustedSize);
+    return bp;
+}
+
+/*
+ * mm_split_set - cut blocks of at least bytes (block size, headers included)
+ *     from the high end of the free block they are placed in, so large and
+ *     small blocks grow toward each other instead of interleaving; 0 = off
+ */
+void mm_split_set(size_t bytes)
+{
+    splitHigh = bytes;
+}
+
+/*
+ * warm_burst - find_fit이 asize에 실패할 때마다 부른다. 같은 크기가 다른 크기의
+ *     실패 없이 연달아 WARM_BURST번 실패하면 참. 크기가 섞여 들어오면 (binary*-bal처럼) refill하지
+ *     않는다: warm 블록은 헤더상 할당 상태라 find_fit과 병합에 보이지 않으므로,
+ *     여러 크기의 warm 블록이 쌓이면 힙만 늘고 리스트가 길어진다.
+ */
+static int warm_burst(size_t asize)
+{
+    if (asize != warmMissSize) {
+        warmMissSize = asize;
+        warmMissRun = 0;
+        if (asize <= WARM_MAX)
+            warmBatch[asize / DSIZE] = 0;   /* 새 burst는 한 블록부터 다시 */
+    }
+    return ++warmMissRun >= WARM_BURST;
+}
+
+/*
+ * refill - asize 블록이 없을 때: 꼬리를 batch개 분량이 되도록 한 번만 확장하고
+ *     앞에서부터 asize씩 잘라 첫 블록은 반환, 나머지는 warm 리스트에 넣는다.
+ *     batch는 같은 크기의 refill이 반복될 때만 커지므로 드문 크기는 예전처럼
+ *     한 블록만 늘린다. warm 블록은 헤더상 할당 상태라 병합되지 않는다.
+ */
+static void *refill(size_t asize)
+{
+    int idx = asize / DSIZE;
+    int batch = warmBatch[idx] ? warmBatch[idx] : 1;
+    size_t tail = getFreeSizeOfTail();
+    size_t total = batch * asize;
+    char *bp, *blk;
+
+    if (total > tail && extend_heap((total - tail + (WSIZE - 1)) / WSIZE) == NULL)
+        return NULL;
+    bp = (char *)mem_heap_hi() + 1 - getFreeSizeOfTail();   /* 꼬리 free 블록 */
+    if (!recommit_allowed(bp))
+        return NULL;
+    if (GET_SIZE(HDRP(bp)) - total < MIN_FREE_BLK)
+        total = GET_SIZE(HDRP(bp));     /* 자투리는 마지막 블록에 붙임 */
+    place(bp, total);
+
+    /* [bp, bp+total)을 asize 블록으로; 마지막 블록이 나머지를 가짐.
+     * batch가 1이면 첫 블록이 total을 그대로 가지므로 live 바이트도 그대로 둔다 */
+    if (batch > 1)
+        MM_STAT_SUB(live_bytes, total - asize);   /* warm 블록은 꺼낼 때 센다 */
+    for (int i = batch - 1; i >= 1; i--) {
+        blk = bp + i * asize;
+        size_t bsize = (i == batch - 1) ? total - i * asize : asize;
+        PUT(HDRP(blk), PACK(bsize, 1));
+        PUT(FTRP(blk), PACK(bsize, 1));
+        *(char **)blk = warmList[idx];
+        warmList[idx] = blk;
     }
+    if (batch > 1) {
+        warmMask |= 1u << idx;
+        PUT(HDRP(bp), PACK(asize, 1));
+        PUT(FTRP(bp), PACK(asize, 1));
+    }
+    if (batch < WARM_BATCH_MAX)
+        warmBatch[idx] = batch * 2;
+    return bp;
+}
+
+/* warm 리스트의 블록을 모두 free로 돌려 병합 (힙 확장 직전, heap budget 회수에서 사용) */
+static void warm_flush(void)
+{
+    for (; warmMask != 0; warmMask &= warmMask - 1) {
+        int idx = __builtin_ctz(warmMask);
+        char *bp = warmList[idx];
+        warmList[idx] = NULL;
+        warmBatch[idx] = 0;
+        while (bp != NULL) {
+            char *next = *(char **)bp;
+            size_t size = GET_SIZE(HDRP(bp));
+            PUT(HDRP(bp), PACK(size, 0));
+            PUT(FTRP(bp), PACK(size, 0));
+            coalesce(bp);
+            bp = next;
+        }
+    }
+}
+
+/*
+ * Free-list reordering
+ *
+ * LIFO 삽입이 오래 돌면 class 리스트는 주소상 무작위 순서가 되어, 같은 크기를 연달아
+ * 할당해도 블록이 힙 곳곳에 흩어진다. 그래서 리스트를 제자리에서 natural merge
+ * sort 한다: 오름차순 run A의 끝을 찾고(SCAN), 바로 뒤 run B의 노드를 A의 알맞은
+ * 자리 앞으로 하나씩 옮기고(MERGE), 합친 뒤에는 B의 나머지를 건너뛰어(SKIP) 다음
+ * run으로 간다. 한 단계가 노드 하나만 다루고 그 사이에도 리스트는 항상 온전하므로
+ * 아무 때나 멈췄다 이어 갈 수 있다. group 하나를 한 바퀴 돌면 다음 group으로 넘어가고,
+ * 바퀴마다 run 수가 절반쯤으로 줄어 몇 바퀴면 리스트가 정렬된다.
+ *
+ * 멈춘 사이에 remove_node가 커서 노드를 빼면 커서는 succ로 넘어간다 (같은 리스트
+ * 안이므로 안전). insert_node가 run 중간에 넣은 노드는 정렬을 조금 흐릴 뿐이다.
+ *
+ * 정렬 키가 (크기, 주소)인 것은 정확한 크기 인덱스 때문이다: 같은 크기 블록이
+ * 대표(rep)부터 연속이어야 rep가 빠질 때 succ가 이어받는다. 같은 크기의 rep 바로
+ * 앞으로 옮긴 노드는 새 rep가 된다. 연속성이 잠시 깨져도 rep는 여전히 그 크기의
+ * free 블록이므로 정확성에는 영향이 없다 (연속성은 성능 속성일 뿐).
+ * 블록을 옮기거나 상태를 바꾸지 않으므로 malloc/free 경로는 그대로다.
+ */
+static int reorder_before(const char *a, const char *b)
+{
+    size_t sa = GET_SIZE(HDRP(a)), sb = GET_SIZE(HDRP(b));
+    return sa < sb || (sa == sb && a < b);
+}
+
+/* b를 리스트에서 떼어 a 바로 앞에 붙인다 (둘은 같은 class 리스트) */
+static void reorder_move(char *b, char *a)
+{
+    char *bp = GET_PRED(b), *bs = GET_SUCC(b), *ap;
+
+    SET_SUCC(bp, bs);                  /* b는 A 뒤에 있으므로 pred가 있다 */
+    if (bs != NULL)
+        SET_PRED(bs, bp);
+
+    ap = GET_PRED(a);
+    SET_PRED(b, ap);
+    SET_SUCC(b, a);
+    SET_PRED(a, b);
+    if (ap != NULL)
+        SET_SUCC(ap, b);
+    else
+        headers[reorderGroup] = b;
+
+    size_t size = GET_SIZE(HDRP(b));
+    exact_slot_t *slot = exact_find(size);
+    if (slot->rep == a)
+        slot->rep = b;
+}
+
+/* 한 단계 (노드 하나만큼) 진행 */
+static void reorder_advance(void)
+{
+    char *next;
+
+    switch (reorderPhase) {
+    case RO_START:
+        reorderRun = reorderA = headers[reorderGroup];
+        reorderPhase = RO_SCAN;
+        break;
+
+    case RO_SCAN:
+        if (reorderA == NULL || (next = GET_SUCC(reorderA)) == NULL) {
+            /* 리스트 끝: 이 group의 한 바퀴가 끝남 */
+            reorderGroup = (reorderGroup + 1) % NLISTS;
+            reorderRun = reorderA = reorderB = NULL;
+            reorderPhase = RO_START;
+        } else if (!reorder_before(next, reorderA)) {
+            reorderA = next;
+        } else {
+            reorderB = next;
+            reorderA = reorderRun;
+            reorderPhase = RO_MERGE;
+        }
+        break;
+
+    case RO_MERGE:
+        if (reorderB == NULL) {
+            reorderPhase = RO_SCAN;    /* B가 전부 빠짐: 다음 run부터 */
+            reorderRun = reorderA = NULL;
+        } else if (reorderA == reorderB) {
+            reorderPhase = RO_SKIP;    /* A를 다 씀: B의 나머지는 이미 제자리 */
+        } else if (reorder_before(reorderB, reorderA)) {
+            char *b = reorderB;
+            next = GET_SUCC(b);
+            reorder_move(b, reorderA);
+            if (next == NULL || reorder_before(next, b)) {
+                /* B가 끝남: 다음 run은 next부터 */
+                reorderRun = reorderA = next;
+                reorderB = NULL;
+                reorderPhase = RO_SCAN;
+            } else {
+                reorderB = next;
+            }
+        } else {
+            reorderA = GET_SUCC(reorderA);
+        }
+        break;
+
+    case RO_SKIP:
+        next = (reorderB != NULL) ? GET_SUCC(reorderB) : NULL;
+        if (next == NULL || reorder_before(next, reorderB)) {
+            reorderRun = reorderA = next;
+            reorderB = NULL;
+            reorderPhase = RO_SCAN;
+        } else {
+            reorderB = next;
+        }
+        break;
+    }
+}
+
+/*
+ * mm_reorder_step - advance the incremental sort of the class lists toward
+ *     (size, address) order by nblocks nodes, resuming where the last call
+ *     stopped; call it when idle, or let the allocator's slow path do it
+ *     with mm_reorder_set_budget
+ */
+void mm_reorder_step(int nblocks)
+{
+    while (nblocks-- > 0)
+        reorder_advance();
+}
+
+/*
+ * mm_reorder_set_budget - reorder nblocks free-list nodes whenever a
+ *     malloc misses the free lists and has to grow the heap; mm_free and
+ *     the find_fit hits stay untouched (0 turns it off)
+ */
+void mm_reorder_set_budget(int nblocks)
+{
+    reorderBudget = nblocks > 0 ? nblocks : 0;
 }
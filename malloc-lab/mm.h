@@ -4,6 +4,43 @@ extern int mm_init (void);
 extern void *mm_malloc (size_t size);
 extern void mm_free (void *ptr);
 extern void *mm_realloc(void *ptr, size_t size);
+extern size_t mm_usable_size(void *ptr);
+extern void *mm_reserve(size_t max_bytes);
+extern int mm_grow(void *ptr, size_t new_size);
+extern void mm_release(void *ptr);
+extern void *mm_malloc_near(void *hint, size_t size);
+extern void mm_copy_set_threshold(size_t bytes);
+extern int mm_heap_set_limit(size_t soft, size_t hard);
+extern size_t mm_heap_committed(void);
+extern void mm_nursery_set(size_t chunk_bytes);
+extern void mm_align_set(size_t lo, size_t hi);
+extern void mm_split_set(size_t bytes);
+extern void mm_reorder_step(int nblocks);
+extern void mm_reorder_set_budget(int nblocks);
+
+/* Heap consistency checker */
+extern void mm_checkheap(int lineno);
+extern void mm_check_set_budget(int nblocks);
+extern int mm_check_errors(void);
+
+/* Fragmentation breakdown of the current heap, in bytes (sums to mem_heapsize) */
+typedef struct {
+    size_t payload;    /* requested bytes of live blocks */
+    size_t hdr_ftr;    /* boundary tags of live blocks */
+    size_t align;      /* rounding up to the 8-byte grid and the minimum block */
+    size_t special;    /* 448 -> 512 and 112 -> 128 size bumps */
+    size_t remainder;  /* split remainders too small to be a free block */
+    size_t cached;     /* allocated in the heap but not handed out (warm lists) */
+    size_t external;   /* free blocks other than the tail */
+    size_t tail;       /* free block at the end of the heap */
+    size_t other;      /* prologue, epilogue and initial padding */
+} mm_frag_t;
+extern void mm_frag_block(void *ptr, size_t request, mm_frag_t *f);
+extern void mm_frag_heap(mm_frag_t *f);
+
+/* Sampling heap profiler (mm_sample.c) */
+extern void mm_sample_set_interval(size_t bytes);
+extern void mm_sample_dump(FILE *fp);
 
 
 /* 
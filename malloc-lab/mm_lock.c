@@ -0,0 +1,128 @@
+/*
+ * mm_lock.c - slow paths of the ticket lock: backoff, futex sleep, timing
+ */
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+
+#include "mm_lock.h"
+
+#define SPIN_UNIT   32                 /* pauses per waiter ahead of us */
+#define SPIN_YIELD  4096               /* backoff rounds before sched_yield */
+
+int mm_lock_timing = 0;
+static uint32_t queue_max;             /* ticket holders allowed: online CPUs */
+
+static inline void cpu_relax(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+static long futex(uint32_t *uaddr, int op, uint32_t val)
+{
+    return syscall(SYS_futex, uaddr, op, val, NULL, NULL, 0);
+}
+
+uint64_t mm_lock_now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+void mm_lock_init(mm_lock_t *lk)
+{
+    mm_lock_t zero = MM_LOCK_INITIALIZER;
+    *lk = zero;
+}
+
+/*
+ * mm_lock_set_timing - measure wait and hold times (two clock reads per
+ *     acquisition); counts of acquisitions, contention and sleeps are kept
+ *     regardless
+ */
+void mm_lock_set_timing(int on)
+{
+    mm_lock_timing = on;
+}
+
+/*
+ * mm_lock_slow - the lock was busy: take a ticket if the queue has room and
+ *     spin until it is served, otherwise sleep until an unlock
+ */
+void mm_lock_slow(mm_lock_t *lk)
+{
+    uint32_t ticket, cur, n, spun = 0;
+    uint64_t sleeps = 0;
+
+    if (queue_max == 0) {
+        long ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+        queue_max = (ncpu > 1) ? (uint32_t)ncpu : 1;
+    }
+
+    for (;;) {
+        n = __atomic_load_n(&lk->next, __ATOMIC_RELAXED);
+        cur = __atomic_load_n(&lk->owner, __ATOMIC_ACQUIRE);
+        if (n - cur < queue_max) {
+            if (__atomic_compare_exchange_n(&lk->next, &n, n + 1, 0,
+                                            __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+                break;
+            continue;
+        }
+        /* 줄이 꽉 참: cur을 읽은 뒤에 owner가 바뀌었으면 futex가 바로 돌아온다 */
+        __atomic_add_fetch(&lk->sleepers, 1, __ATOMIC_SEQ_CST);
+        futex(&lk->owner, FUTEX_WAIT_PRIVATE, cur);
+        __atomic_sub_fetch(&lk->sleepers, 1, __ATOMIC_SEQ_CST);
+        sleeps++;
+    }
+
+    ticket = n;
+    while ((cur = __atomic_load_n(&lk->owner, __ATOMIC_ACQUIRE)) != ticket) {
+        /* 앞에 대기자가 많을수록 오래 쉰다: owner 캐시 라인을 덜 두드림 */
+        uint32_t k = (ticket - cur) * SPIN_UNIT;
+        for (uint32_t i = 0; i < k; i++)
+            cpu_relax();
+        /* 앞 사람이 선점당했으면 CPU를 양보 (티켓을 쥔 채로는 잘 수 없다) */
+        if (++spun % SPIN_YIELD == 0)
+            sched_yield();
+    }
+
+    /* 여기서부터 락을 쥐고 있음 */
+    lk->stats.contended++;
+    lk->stats.sleeps += sleeps;
+}
+
+/*
+ * mm_lock_wake - one sleeper retries for a place in the queue
+ */
+void mm_lock_wake(mm_lock_t *lk)
+{
+    futex(&lk->owner, FUTEX_WAKE_PRIVATE, 1);
+}
+
+/* Timing hooks, called with the lock held */
+void mm_lock_timed_acquired(mm_lock_t *lk, uint64_t t_start)
+{
+    uint64_t now = mm_lock_now(), wait = now - t_start;
+
+    lk->stats.wait_ns += wait;
+    if (wait > lk->stats.wait_max)
+        lk->stats.wait_max = wait;
+    lk->t_acquired = now;
+}
+
+void mm_lock_timed_release(mm_lock_t *lk)
+{
+    uint64_t hold = mm_lock_now() - lk->t_acquired;
+
+    lk->stats.hold_ns += hold;
+    if (hold > lk->stats.hold_max)
+        lk->stats.hold_max = hold;
+    lk->t_acquired = 0;
+}
@@ -0,0 +1,75 @@
+#ifndef __MM_LOCK_H_
+#define __MM_LOCK_H_
+
+/*
+ * mm_lock.h - contention-adaptive ticket lock for the shared heaps
+ *
+ * 티켓 락: 경합이 없으면 CAS 한 번으로 잡고 store 한 번으로 푼다. 경합이 있으면
+ * 티켓을 받아 FIFO로 줄을 서서, 자기 차례까지 남은 대기자 수에 비례해 pause로
+ * backoff 하며 돈다.
+ *
+ * 줄의 길이는 온라인 CPU 수로 제한한다. 줄이 꽉 찼을 때 온 스레드는 티켓을 받지
+ * 않고 owner 워드에서 futex로 잠들고, unlock이 하나씩 깨운다. 그래서 줄에 선
+ * 스레드는 거의 항상 실행 중이고(spin이 헛되지 않음), 스레드가 코어보다 많아도
+ * 잠든 스레드 앞으로 티켓이 넘어가 생기는 convoy가 없다. 코어가 하나면 줄은
+ * 락을 쥔 스레드뿐이므로 futex mutex처럼 동작한다.
+ *
+ * 통계(획득 수, 경합 수, 잠든 횟수)는 항상 세고, 대기/점유 시간은
+ * mm_lock_set_timing(1) 일 때만 잰다. 통계는 락을 쥔 스레드만 갱신한다.
+ */
+
+#include <stdint.h>
+
+typedef struct {
+    uint64_t acquire;                  /* lock() calls */
+    uint64_t contended;                /* lock was not free on arrival */
+    uint64_t sleeps;                   /* futex waits (queue was full) */
+    uint64_t wait_ns, wait_max;        /* time from lock() to ownership */
+    uint64_t hold_ns, hold_max;        /* time from ownership to unlock() */
+} mm_lock_stats_t;
+
+typedef struct {
+    uint32_t next;                     /* next ticket to hand out */
+    uint32_t owner;                    /* ticket being served (futex word) */
+    uint32_t sleepers;                 /* threads in futex_wait */
+    uint32_t pad;
+    uint64_t t_acquired;               /* owner's acquisition time (timing only) */
+    mm_lock_stats_t stats;
+} __attribute__((aligned(64))) mm_lock_t;
+
+#define MM_LOCK_INITIALIZER { 0, 0, 0, 0, 0, { 0 } }
+
+void mm_lock_init(mm_lock_t *lk);
+void mm_lock_slow(mm_lock_t *lk);
+void mm_lock_wake(mm_lock_t *lk);
+void mm_lock_set_timing(int on);
+void mm_lock_timed_acquired(mm_lock_t *lk, uint64_t t_start);
+void mm_lock_timed_release(mm_lock_t *lk);
+uint64_t mm_lock_now(void);
+
+extern int mm_lock_timing;
+
+static inline void mm_lock(mm_lock_t *lk)
+{
+    uint64_t t0 = mm_lock_timing ? mm_lock_now() : 0;
+    uint32_t cur = __atomic_load_n(&lk->owner, __ATOMIC_ACQUIRE);
+
+    if (!__atomic_compare_exchange_n(&lk->next, &cur, cur + 1, 0,
+                                     __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+        mm_lock_slow(lk);
+    lk->stats.acquire++;
+    if (t0)
+        mm_lock_timed_acquired(lk, t0);
+}
+
+static inline void mm_unlock(mm_lock_t *lk)
+{
+    if (lk->t_acquired)
+        mm_lock_timed_release(lk);
+    /* owner store와 sleepers load 사이의 순서가 깨지면 깨우기를 놓친다 */
+    __atomic_store_n(&lk->owner, lk->owner + 1, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&lk->sleepers, __ATOMIC_SEQ_CST) != 0)
+        mm_lock_wake(lk);
+}
+
+#endif /* __MM_LOCK_H_ */
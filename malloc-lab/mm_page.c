@@ -0,0 +1,581 @@
+/*
+ * mm_page.c - page-local free-list sharding (mimalloc-style engine)
+ *
+ * - 힙을 MP_PAGE_SIZE(64KB) 정렬 페이지로 나누고, 페이지 하나는 size class 하나만 담당
+ * - 블록에는 헤더가 없다: free(p)는 p를 페이지 크기로 내림해서 페이지 헤더를 찾는다
+ * - 페이지마다 free 리스트가 셋:
+ *     free        : 할당은 여기서만 pop (fast path: 분기 하나 + pop)
+ *     local_free  : 소유 스레드가 free한 블록
+ *     thread_free : 다른 스레드가 free한 블록 (atomic push)
+ *   free가 비면 local_free를 통째로 옮기고, 그래도 비면 thread_free를 atomic
+ *   exchange로 가져온다. 그래서 할당은 한 페이지 안에 모이고 free는 페이지 로컬이다.
+ * - 스레드마다 heap이 있고, heap은 class별 페이지 큐를 가진다
+ * - 빈 페이지와 큰 블록(MP_SMALL_MAX 초과, 여러 페이지 span)은 전역 pool에서 얻고 돌려준다
+ * - Hoard식 blowup 제한: 페이지를 superblock으로 보고, 스레드 heap의 사용량 u가
+ *   보유량 a에 비해 u < a - K*S 이고 u < (1-f)*a 가 되면 f 이상 비어 있는 페이지를
+ *   전역 heap으로 넘긴다. 새 페이지가 필요한 스레드는 sbrk 전에 전역 heap에서 가져간다.
+ *   스레드가 끝나면 그 heap의 페이지도 전부 전역 heap으로 간다.
+ * - 공유 자료구조는 mm_lock(티켓 락 + backoff + futex)으로 보호: pool과 heap
+ *   배정은 pool_lock 하나, 전역 heap의 class별 페이지 리스트는 class마다 따로
+ * - 통계는 항상 켜져 있고 스레드별 shard에 쌓는다 (mm_stats.h); mp_stats가 합산.
+ *   -DMP_SHARED_STATS로 빌드하면 비교용으로 전역 카운터 하나에 atomic add 한다
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+
+#include "mm_page.h"
+#include "mm_stats.h"
+#include "memlib.h"
+
+#define MP_PAGE_SHIFT   16
+#define MP_PAGE_SIZE    ((size_t)1 << MP_PAGE_SHIFT)         /* 64 KB */
+#define MP_PAGE_HDR     128                                  /* header area, keeps blocks 16B aligned */
+#define MP_SMALL_MAX    8192                                 /* largest size served from a class page */
+#define MP_NCLASS       40
+#define MP_MAX_HEAPS    256                                  /* live threads that can own a heap */
+#define MP_RELEASE_PCT  25                                   /* f: emptiness fraction, percent */
+#define MP_RELEASE_K    4                                    /* K: slack, in pages */
+
+#define PAGE_OF(p)      ((mp_page_t *)((uintptr_t)(p) & ~(MP_PAGE_SIZE - 1)))
+
+typedef struct mp_block {
+    struct mp_block *next;
+} mp_block_t;
+
+struct mp_heap;
+
+typedef struct mp_page {
+    struct mp_page *next;            /* heap class queue / pool free list */
+    struct mp_page *prev;
+    struct mp_heap *heap;            /* owner (NULL while in the pool) */
+    mp_block_t *free;                /* allocation list */
+    mp_block_t *local_free;          /* freed by the owner */
+    mp_block_t *thread_free;         /* freed by other threads (atomic) */
+    char *bump;                      /* never-used space, carved lazily */
+    char *end;
+    uint32_t block_size;             /* 0 for a large span */
+    uint32_t used;                   /* blocks out, as far as the owner knows */
+    uint32_t capacity;
+    uint32_t npages;                 /* span length in pages */
+    int cls;
+} mp_page_t;
+
+typedef struct mp_heap {
+    mp_page_t *pages[MP_NCLASS];     /* class queues; head is the current page */
+    size_t in_use;                   /* u: bytes in blocks handed out */
+    size_t held;                     /* a: bytes in pages owned */
+    size_t trim_mark;                /* in_use at the last trim attempt */
+    unsigned generation;
+    struct mp_heap *next_free;       /* free slot list (pool_lock) */
+} mp_heap_t;
+
+#ifdef MP_SHARED_STATS
+static mm_shard_t shared_stats;      /* one counter set for every thread */
+#define MP_STAT(f, d) __atomic_fetch_add(&shared_stats.f, (uint64_t)(d), __ATOMIC_RELAXED)
+#else
+#define MP_STAT(f, d) MM_SHARD_ADD(f, d)
+#endif
+
+/* Globals */
+static size_t class_size[MP_NCLASS];
+static int nclass;
+static unsigned char size_class[MP_SMALL_MAX / 16 + 1];   /* (size+15)/16 -> class */
+
+static mm_lock_t pool_lock = MM_LOCK_INITIALIZER;   /* pool, heaps[], sbrk */
+static mm_lock_t class_lock[MP_NCLASS];             /* global.pages[cls] */
+static mp_page_t *pool;              /* free spans, any length */
+static mp_heap_t heaps[MP_MAX_HEAPS];
+static int nheaps;
+static mp_heap_t *free_heaps;        /* slots of exited threads, for reuse */
+static unsigned generation;          /* bumped by mp_init; invalidates thread heaps */
+static mp_heap_t global;             /* released superblocks, per class (class_lock) */
+static int release_pct = MP_RELEASE_PCT;
+static size_t release_slack = MP_RELEASE_K * MP_PAGE_SIZE;
+static pthread_key_t heap_key;
+static pthread_once_t heap_key_once = PTHREAD_ONCE_INIT;
+
+static __thread mp_heap_t *tl_heap;
+static __thread unsigned tl_generation;
+
+/* Internal helpers (prototypes) */
+static void init_classes(void);
+static mp_heap_t *my_heap(void);
+static mp_page_t *span_acquire(size_t npages);
+static void span_release(mp_page_t *page);
+static void *malloc_generic(mp_heap_t *heap, int cls);
+static void page_collect(mp_page_t *page);
+static void queue_remove(mp_heap_t *heap, mp_page_t *page);
+static void queue_push(mp_heap_t *heap, mp_page_t *page);
+static void page_release(mp_heap_t *heap, mp_page_t *page);
+static mp_page_t *page_adopt(mp_heap_t *heap, int cls);
+static void heap_trim(mp_heap_t *heap);
+static void heap_abandon(void *arg);
+
+/*
+ * init_classes - 16B 간격으로 128B까지, 그 위로는 2배마다 4단계씩 MP_SMALL_MAX까지
+ */
+static void init_classes(void)
+{
+    size_t sz, i;
+    int c = 0;
+
+    nclass = 0;
+    for (sz = 16; sz <= 128; sz += 16)
+        class_size[nclass++] = sz;
+    for (sz = 128; sz < MP_SMALL_MAX; sz *= 2)
+        for (int k = 1; k <= 4; k++)
+            class_size[nclass++] = sz + k * (sz / 4);
+
+    for (i = 0; i <= MP_SMALL_MAX / 16; i++) {
+        while (class_size[c] < i * 16)
+            c++;
+        size_class[i] = (unsigned char)c;
+    }
+}
+
+static void make_heap_key(void)
+{
+    pthread_key_create(&heap_key, heap_abandon);
+}
+
+int mp_init(void)
+{
+    char *brk;
+    size_t pad;
+
+    if (nclass == 0)
+        init_classes();
+
+    /* 힙 시작을 페이지 경계로 맞춤 */
+    brk = (char *)mem_heap_hi() + 1;
+    pad = (MP_PAGE_SIZE - ((uintptr_t)brk & (MP_PAGE_SIZE - 1))) & (MP_PAGE_SIZE - 1);
+    if (pad && mem_sbrk((int)pad) == (void *)-1)
+        return -1;
+
+    pthread_once(&heap_key_once, make_heap_key);
+    mm_lock(&pool_lock);
+    pool = NULL;
+    memset(heaps, 0, sizeof(heaps));
+    memset(&global, 0, sizeof(global));
+    for (int c = 0; c < MP_NCLASS; c++)
+        mm_lock_init(&class_lock[c]);
+    nheaps = 0;
+    free_heaps = NULL;
+    __atomic_add_fetch(&generation, 1, __ATOMIC_RELEASE);
+    mm_unlock(&pool_lock);
+    memset(&pool_lock.stats, 0, sizeof(pool_lock.stats));
+    return 0;
+}
+
+/*
+ * mp_lock_stats - lock statistics since mp_init: the pool lock and the
+ *     per-class global heap locks, summed
+ */
+void mp_lock_stats(mm_lock_stats_t *pool_st, mm_lock_stats_t *class_st)
+{
+    *pool_st = pool_lock.stats;
+    memset(class_st, 0, sizeof(*class_st));
+    for (int c = 0; c < MP_NCLASS; c++) {
+        mm_lock_stats_t *st = &class_lock[c].stats;
+        class_st->acquire += st->acquire;
+        class_st->contended += st->contended;
+        class_st->sleeps += st->sleeps;
+        class_st->wait_ns += st->wait_ns;
+        class_st->hold_ns += st->hold_ns;
+        if (st->wait_max > class_st->wait_max)
+            class_st->wait_max = st->wait_max;
+        if (st->hold_max > class_st->hold_max)
+            class_st->hold_max = st->hold_max;
+    }
+}
+
+/* 호출 스레드의 heap (mp_init 이후 처음 부르면 하나 배정, 끝난 스레드의 것부터 재사용) */
+static mp_heap_t *my_heap(void)
+{
+    unsigned gen = __atomic_load_n(&generation, __ATOMIC_ACQUIRE);
+
+    if (tl_heap != NULL && tl_generation == gen)
+        return tl_heap;
+
+    mm_lock(&pool_lock);
+    if (free_heaps != NULL) {
+        tl_heap = free_heaps;
+        free_heaps = tl_heap->next_free;
+    } else if (nheaps < MP_MAX_HEAPS) {
+        tl_heap = &heaps[nheaps++];
+    } else {
+        mm_unlock(&pool_lock);
+        fprintf(stderr, "mm_page: more than %d live threads\n", MP_MAX_HEAPS);
+        abort();
+    }
+    tl_heap->generation = tl_generation = gen;
+    mm_unlock(&pool_lock);
+    pthread_setspecific(heap_key, tl_heap);
+    return tl_heap;
+}
+
+/*
+ * mp_set_release - Hoard emptiness threshold: release a superblock when the
+ *     heap is less than (100 - percent)% used and has more than slack_pages
+ *     pages of slack. percent == 0 keeps pages in their heap forever.
+ */
+void mp_set_release(int percent, int slack_pages)
+{
+    release_pct = percent;
+    release_slack = (size_t)slack_pages * MP_PAGE_SIZE;
+}
+
+/*
+ * span_acquire - npages개의 연속 페이지를 pool에서 first-fit으로 꺼내거나 새로 sbrk
+ */
+static mp_page_t *span_acquire(size_t npages)
+{
+    mp_page_t *page, **pp;
+
+    mm_lock(&pool_lock);
+    for (pp = &pool; (page = *pp) != NULL; pp = &page->next) {
+        if (page->npages < npages)
+            continue;
+        *pp = page->next;
+        if (page->npages > npages) {
+            /* 남는 뒤쪽 페이지는 pool에 다시 넣음 */
+            mp_page_t *rest = (mp_page_t *)((char *)page + npages * MP_PAGE_SIZE);
+            rest->npages = page->npages - npages;
+            rest->next = pool;
+            pool = rest;
+        }
+        mm_unlock(&pool_lock);
+        page->npages = npages;
+        return page;
+    }
+    page = mem_sbrk((int)(npages * MP_PAGE_SIZE));
+    mm_unlock(&pool_lock);
+    if (page == (void *)-1)
+        return NULL;
+    page->npages = npages;
+    return page;
+}
+
+static void span_release(mp_page_t *page)
+{
+    page->heap = NULL;
+    mm_lock(&pool_lock);
+    page->next = pool;
+    pool = page;
+    mm_unlock(&pool_lock);
+}
+
+static void queue_remove(mp_heap_t *heap, mp_page_t *page)
+{
+    if (page->prev != NULL)
+        page->prev->next = page->next;
+    else
+        heap->pages[page->cls] = page->next;
+    if (page->next != NULL)
+        page->next->prev = page->prev;
+    page->next = page->prev = NULL;
+}
+
+static void queue_push(mp_heap_t *heap, mp_page_t *page)
+{
+    page->prev = NULL;
+    page->next = heap->pages[page->cls];
+    if (page->next != NULL)
+        page->next->prev = page;
+    heap->pages[page->cls] = page;
+}
+
+/*
+ * page_collect - local_free와 thread_free를 free 리스트로 모은다
+ */
+static void page_collect(mp_page_t *page)
+{
+    mp_block_t *tf, *b;
+    uint32_t n = 0;
+
+    if (page->free == NULL) {
+        page->free = page->local_free;
+        page->local_free = NULL;
+    }
+    if (page->free == NULL &&
+        __atomic_load_n(&page->thread_free, __ATOMIC_RELAXED) != NULL) {
+        tf = __atomic_exchange_n(&page->thread_free, NULL, __ATOMIC_ACQUIRE);
+        for (b = tf; b != NULL; b = b->next)
+            n++;
+        page->used -= n;
+        page->free = tf;
+    }
+}
+
+/*
+ * page_release - heap에서 페이지를 떼어 전역 heap으로 (완전히 비었으면 pool로)
+ *     local_free는 그대로 두고 새 소유자가 page_collect로 가져간다.
+ */
+static void page_release(mp_heap_t *heap, mp_page_t *page)
+{
+    queue_remove(heap, page);
+    heap->held -= MP_PAGE_SIZE;
+    heap->in_use -= (size_t)page->used * page->block_size;
+    if (page->used == 0) {
+        span_release(page);
+        return;
+    }
+    mm_lock(&class_lock[page->cls]);
+    __atomic_store_n(&page->heap, &global, __ATOMIC_RELEASE);
+    queue_push(&global, page);
+    mm_unlock(&class_lock[page->cls]);
+}
+
+/*
+ * page_adopt - 전역 heap에서 cls 페이지 하나를 가져와 heap 소유로 만든다
+ */
+static mp_page_t *page_adopt(mp_heap_t *heap, int cls)
+{
+    mp_page_t *page;
+
+    if (__atomic_load_n(&global.pages[cls], __ATOMIC_RELAXED) == NULL)
+        return NULL;
+    mm_lock(&class_lock[cls]);
+    if ((page = global.pages[cls]) != NULL) {
+        queue_remove(&global, page);
+        __atomic_store_n(&page->heap, heap, __ATOMIC_RELEASE);
+    }
+    mm_unlock(&class_lock[cls]);
+    if (page == NULL)
+        return NULL;
+
+    page_collect(page);
+    heap->held += MP_PAGE_SIZE;
+    heap->in_use += (size_t)page->used * page->block_size;
+    queue_push(heap, page);
+    return page;
+}
+
+/*
+ * heap_trim - emptiness 불변식 (u >= a - K*S 또는 u >= (1-f)*a) 이 깨졌으면
+ *     가장 비어 있는, 적어도 f 만큼 빈 페이지 하나를 내보낸다
+ */
+static void heap_trim(mp_heap_t *heap)
+{
+    mp_page_t *victim = NULL, *page;
+    uint64_t best = (uint64_t)-1;
+
+    heap->trim_mark = heap->in_use;
+    for (int cls = 0; cls < nclass; cls++) {
+        /* 큐의 head는 곧 다시 쓸 페이지: 내보내면 바로 adopt로 되찾아 온다 */
+        if (heap->pages[cls] == NULL)
+            continue;
+        for (page = heap->pages[cls]->next; page != NULL; page = page->next) {
+            /* used/capacity 비율을 정수로 비교 */
+            uint64_t fill = (uint64_t)page->used * 1024 / page->capacity;
+            if (fill * 100 <= (uint64_t)(100 - release_pct) * 1024 && fill < best) {
+                best = fill;
+                victim = page;
+            }
+        }
+    }
+    if (victim != NULL)
+        page_release(heap, victim);
+}
+
+/*
+ * heap_abandon - thread exit: hand every page to the global heap and put
+ *     the emptied slot on the free list for the next new thread
+ */
+static void heap_abandon(void *arg)
+{
+    mp_heap_t *heap = arg;
+
+    tl_heap = NULL;         /* 뒤에 도는 소멸자가 할당하면 새 slot을 받는다 */
+    tl_generation = 0;
+    if (heap->generation != __atomic_load_n(&generation, __ATOMIC_ACQUIRE))
+        return;
+    for (int cls = 0; cls < nclass; cls++)
+        while (heap->pages[cls] != NULL)
+            page_release(heap, heap->pages[cls]);
+
+    mm_lock(&pool_lock);
+    if (heap->generation == generation) {   /* mp_init이 그 사이 heaps[]를 비우지 않았으면 */
+        memset(heap, 0, sizeof(*heap));
+        heap->next_free = free_heaps;
+        free_heaps = heap;
+    }
+    mm_unlock(&pool_lock);
+}
+
+/*
+ * malloc_generic - 현재 페이지가 비었을 때: 큐를 돌며 회수 가능한 블록을 찾고,
+ *     없으면 전역 heap의 페이지를 가져오거나 새 페이지를 붙인다
+ */
+static void *malloc_generic(mp_heap_t *heap, int cls)
+{
+    mp_page_t *page;
+    mp_block_t *b;
+
+    MP_STAT(n_slow, 1);
+    if (heap->in_use > heap->trim_mark)
+        heap->trim_mark = heap->in_use;
+    for (page = heap->pages[cls]; page != NULL; page = page->next) {
+        uint32_t used = page->used;
+        page_collect(page);
+        heap->in_use -= (size_t)(used - page->used) * page->block_size;
+        if (page->free != NULL || page->bump + page->block_size <= page->end) {
+            if (page != heap->pages[cls]) {
+                queue_remove(heap, page);
+                queue_push(heap, page);
+            }
+            break;
+        }
+    }
+
+    if (page == NULL && (page = page_adopt(heap, cls)) != NULL &&
+        page->free == NULL && page->bump + page->block_size > page->end) {
+        /* 전역에 있던 페이지가 아직 가득 참 (다른 스레드의 free가 오기 전) */
+        page = NULL;
+    }
+
+    if (page == NULL) {
+        if ((page = span_acquire(1)) == NULL)
+            return NULL;
+        heap->held += MP_PAGE_SIZE;
+        page->heap = heap;
+        page->cls = cls;
+        page->block_size = class_size[cls];
+        page->free = page->local_free = page->thread_free = NULL;
+        page->bump = (char *)page + MP_PAGE_HDR;
+        page->end = (char *)page + MP_PAGE_SIZE;
+        page->capacity = (MP_PAGE_SIZE - MP_PAGE_HDR) / page->block_size;
+        page->used = 0;
+        queue_push(heap, page);
+    }
+
+    if ((b = page->free) != NULL) {
+        page->free = b->next;
+    } else {
+        b = (mp_block_t *)page->bump;
+        page->bump += page->block_size;
+    }
+    page->used++;
+    heap->in_use += page->block_size;
+    return b;
+}
+
+void *mp_malloc(size_t size)
+{
+    mp_heap_t *heap;
+    mp_page_t *page;
+    mp_block_t *b;
+
+    if (size == 0)
+        return NULL;
+    MP_STAT(n_malloc, 1);
+    MP_STAT(alloc_bytes, size);
+
+    if (size > MP_SMALL_MAX) {
+        size_t npages = (size + MP_PAGE_HDR + MP_PAGE_SIZE - 1) >> MP_PAGE_SHIFT;
+        if ((page = span_acquire(npages)) == NULL)
+            return NULL;
+        page->heap = NULL;
+        page->block_size = 0;
+        page->capacity = 1;
+        return (char *)page + MP_PAGE_HDR;
+    }
+
+    heap = my_heap();
+    int cls = size_class[(size + 15) >> 4];
+    page = heap->pages[cls];
+    /* fast path */
+    if (page != NULL && (b = page->free) != NULL) {
+        page->free = b->next;
+        page->used++;
+        heap->in_use += page->block_size;
+        return b;
+    }
+    return malloc_generic(heap, cls);
+}
+
+void mp_free(void *ptr)
+{
+    mp_page_t *page;
+    mp_block_t *b = ptr;
+
+    if (ptr == NULL)
+        return;
+    MP_STAT(n_free, 1);
+
+    page = PAGE_OF(ptr);
+    if (page->block_size == 0) {
+        span_release(page);
+        return;
+    }
+
+    mp_heap_t *heap = my_heap();
+    if (__atomic_load_n(&page->heap, __ATOMIC_ACQUIRE) == heap) {
+        /* 소유 스레드: 페이지 로컬 리스트에 넣음 */
+        b->next = page->local_free;
+        page->local_free = b;
+        heap->in_use -= page->block_size;
+        if (--page->used == 0 && page != heap->pages[page->cls]) {
+            queue_remove(heap, page);
+            heap->held -= MP_PAGE_SIZE;
+            span_release(page);
+        } else if (release_pct > 0 && heap->in_use + release_slack < heap->held &&
+                   heap->in_use * 100 < heap->held * (100 - release_pct) &&
+                   heap->in_use + MP_PAGE_SIZE <= heap->trim_mark) {
+            /* 지난 시도 뒤로 한 페이지만큼 더 비었을 때만 다시 훑는다 */
+            heap_trim(heap);
+        }
+        return;
+    }
+
+    /* 다른 스레드: thread_free에 lock-free push, 소유자가 나중에 회수 */
+    MP_STAT(n_remote_free, 1);
+    mp_block_t *head = __atomic_load_n(&page->thread_free, __ATOMIC_RELAXED);
+    do {
+        b->next = head;
+    } while (!__atomic_compare_exchange_n(&page->thread_free, &head, b, 1,
+                                          __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+}
+
+void *mp_realloc(void *ptr, size_t size)
+{
+    mp_page_t *page;
+    size_t old;
+    void *newp;
+
+    if (ptr == NULL)
+        return mp_malloc(size);
+    if (size == 0) {
+        mp_free(ptr);
+        return NULL;
+    }
+    MP_STAT(n_realloc, 1);
+
+    page = PAGE_OF(ptr);
+    old = page->block_size ? page->block_size
+                           : page->npages * MP_PAGE_SIZE - MP_PAGE_HDR;
+    if (size <= old && (page->block_size == 0 || size > old / 2))
+        return ptr;
+
+    if ((newp = mp_malloc(size)) == NULL)
+        return NULL;
+    memcpy(newp, ptr, size < old ? size : old);
+    mp_free(ptr);
+    return newp;
+}
+
+/*
+ * mp_stats - counters of every thread so far, summed (cumulative across
+ *     mp_init)
+ */
+void mp_stats(mm_shard_t *out)
+{
+#ifdef MP_SHARED_STATS
+    *out = shared_stats;
+#else
+    mm_shard_sum(out);
+#endif
+}
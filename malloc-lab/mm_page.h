@@ -0,0 +1,25 @@
+#ifndef __MM_PAGE_H_
+#define __MM_PAGE_H_
+
+/*
+ * mm_page.h - page-local free-list engine (mimalloc-style), thread-safe
+ *
+ * mm.c의 segregated-list 엔진과 같은 memlib 힙 위에서 동작하는 대안 엔진.
+ * 이름이 겹치지 않도록 mp_ 접두사를 쓰므로 두 엔진을 한 바이너리에서 비교할 수 있다.
+ * (단, 같은 memlib 힙을 동시에 쓰면 안 된다: 한 번에 하나의 엔진만 init 할 것)
+ */
+
+#include <stddef.h>
+
+#include "mm_lock.h"
+#include "mm_stats.h"
+
+int   mp_init(void);
+void *mp_malloc(size_t size);
+void  mp_free(void *ptr);
+void *mp_realloc(void *ptr, size_t size);
+void  mp_set_release(int percent, int slack_pages);
+void  mp_lock_stats(mm_lock_stats_t *pool_st, mm_lock_stats_t *class_st);
+void  mp_stats(mm_shard_t *out);
+
+#endif /* __MM_PAGE_H_ */
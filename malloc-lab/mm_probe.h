@@ -0,0 +1,85 @@
+#ifndef __MM_PROBE_H_
+#define __MM_PROBE_H_
+
+/*
+ * mm_probe.h - USDT(static tracepoint) probes for the mm package
+ *
+ * 각 probe는 nop 한 개 + .note.stapsdt 노트로 컴파일된다. 아무도 붙지 않았을 때는
+ * nop만 실행되므로 비용이 사실상 0이고, 붙을 때는 bpftrace/perf/systemtap이
+ * nop 자리에 breakpoint를 심는다. 예:
+ *
+ *   unix> bpftrace -e 'usdt:./mdriver:mm:malloc_ret { @[arg0] = count(); }'
+ *   unix> readelf -n mdriver | grep -A3 stapsdt
+ *
+ * <sys/sdt.h>(systemtap-sdt-dev)가 있으면 그것을 쓰고, 없으면 x86-64용으로
+ * 같은 노트 형식을 직접 내보낸다. 그 외 아키텍처이거나 -DMM_NO_PROBES면 no-op.
+ * 모든 인자는 long으로 넘어간다.
+ */
+
+#if !defined(MM_NO_PROBES) && defined(__has_include)
+#if __has_include(<sys/sdt.h>)
+#include <sys/sdt.h>
+#define MM_PROBE_SDT 1
+#endif
+#endif
+
+#if defined(MM_PROBE_SDT)
+
+#define MM_PROBE0(name)             DTRACE_PROBE(mm, name)
+#define MM_PROBE1(name, a)          DTRACE_PROBE1(mm, name, (long)(a))
+#define MM_PROBE2(name, a, b)       DTRACE_PROBE2(mm, name, (long)(a), (long)(b))
+#define MM_PROBE3(name, a, b, c)    DTRACE_PROBE3(mm, name, (long)(a), (long)(b), (long)(c))
+
+#elif !defined(MM_NO_PROBES) && defined(__GNUC__) && defined(__x86_64__)
+
+/*
+ * sys/sdt.h 없이 내보내는 stapsdt 노트 (version 3)
+ *   nop 주소 / .stapsdt.base 주소 / semaphore(0) / provider / name / args
+ * args는 "8@%rdi 8@%rsi" 꼴이며, %[aN] 자리에 컴파일러가 고른 레지스터가 들어간다.
+ */
+#define MM_PROBE_ASM_(name, args)                                              \
+    "990: nop\n"                                                               \
+    ".pushsection .note.stapsdt,\"?\",\"note\"\n"                              \
+    ".balign 4\n"                                                              \
+    ".4byte 992f-991f, 994f-993f, 3\n"                                         \
+    "991: .asciz \"stapsdt\"\n"                                                \
+    "992: .balign 4\n"                                                         \
+    "993: .8byte 990b\n"                                                       \
+    ".8byte _.stapsdt.base\n"                                                  \
+    ".8byte 0\n"                                                               \
+    ".asciz \"mm\"\n"                                                          \
+    ".asciz \"" #name "\"\n"                                                   \
+    ".asciz \"" args "\"\n"                                                    \
+    "994: .balign 4\n"                                                         \
+    ".popsection\n"                                                            \
+    ".ifndef _.stapsdt.base\n"                                                 \
+    ".pushsection .stapsdt.base,\"aG\",\"progbits\",.stapsdt.base,comdat\n"    \
+    ".weak _.stapsdt.base\n"                                                   \
+    ".hidden _.stapsdt.base\n"                                                 \
+    "_.stapsdt.base: .space 1\n"                                               \
+    ".size _.stapsdt.base, 1\n"                                                \
+    ".popsection\n"                                                            \
+    ".endif\n"
+
+#define MM_PROBE0(name) \
+    __asm__ __volatile__(MM_PROBE_ASM_(name, ""))
+#define MM_PROBE1(name, a) \
+    __asm__ __volatile__(MM_PROBE_ASM_(name, "8@%[a1]") \
+                         :: [a1] "r"((long)(a)))
+#define MM_PROBE2(name, a, b) \
+    __asm__ __volatile__(MM_PROBE_ASM_(name, "8@%[a1] 8@%[a2]") \
+                         :: [a1] "r"((long)(a)), [a2] "r"((long)(b)))
+#define MM_PROBE3(name, a, b, c) \
+    __asm__ __volatile__(MM_PROBE_ASM_(name, "8@%[a1] 8@%[a2] 8@%[a3]") \
+                         :: [a1] "r"((long)(a)), [a2] "r"((long)(b)), [a3] "r"((long)(c)))
+
+#else
+
+#define MM_PROBE0(name)             do { } while (0)
+#define MM_PROBE1(name, a)          do { (void)(a); } while (0)
+#define MM_PROBE2(name, a, b)       do { (void)(a); (void)(b); } while (0)
+#define MM_PROBE3(name, a, b, c)    do { (void)(a); (void)(b); (void)(c); } while (0)
+
+#endif
+
+#endif /* __MM_PROBE_H_ */
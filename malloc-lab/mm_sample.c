@@ -0,0 +1,249 @@
+/*
+ * mm_sample.c - record sampled allocations and report the live heap profile
+ *
+ * 표본 간격은 평균 interval인 지수분포에서 뽑는다(= 바이트 단위 기하 표본추출).
+ * 크기 s인 블록이 뽑힐 확률은 1 - exp(-s/interval)이므로, 각 표본은
+ * s / (1 - exp(-s/interval)) 바이트를 대표한다고 보고 합산한다.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <limits.h>
+#include <time.h>
+
+#include "mm.h"
+#include "mm_sample.h"
+
+typedef struct {
+    void *bp;                       /* block address */
+    size_t size;                    /* requested bytes */
+    uint64_t opnum;                 /* allocator op index at sampling time */
+    uint64_t nsec;                  /* CLOCK_MONOTONIC timestamp */
+    double weight;                  /* bytes this sample stands for */
+    int live;                       /* still allocated? */
+} sample_t;
+
+long mm_sample_bytes_left = LONG_MAX;
+
+static size_t interval = 0;         /* mean bytes between samples; 0 = off */
+static uint64_t rng_state = 0x9e3779b97f4a7c15ull;
+
+static sample_t samples[MM_SAMPLE_MAX];
+static int nsamples = 0;            /* records in use */
+static int nlive = 0;
+static size_t ndropped = 0;         /* sampled but no room to record */
+
+/*
+ * 죽은 기록은 FIFO 링에 넣어 오래된 것부터 재활용하고, 살아 있는 기록은
+ * bp -> 기록 번호 해시(선형 탐사)로 찾는다. SAMPLED 비트가 선 블록만 조회하므로
+ * record와 release 모두 O(1)이다.
+ */
+#define LIVE_SLOTS (2 * MM_SAMPLE_MAX) /* power of two, at most half full */
+
+static int dead_ring[MM_SAMPLE_MAX];  /* dead records, oldest first */
+static int dead_head = 0, ndead = 0;
+static int live_map[LIVE_SLOTS];      /* record index + 1; 0 = empty */
+
+static unsigned live_hash(void *bp)
+{
+    return (unsigned)(((uintptr_t)bp >> 3) * 0x9e3779b1u) & (LIVE_SLOTS - 1);
+}
+
+static void live_insert(int i)
+{
+    unsigned h = live_hash(samples[i].bp);
+
+    while (live_map[h])
+        h = (h + 1) & (LIVE_SLOTS - 1);
+    live_map[h] = i + 1;
+}
+
+/* Remove bp's entry and return its record index, or -1 */
+static int live_remove(void *bp)
+{
+    unsigned h = live_hash(bp), j, k;
+    int i;
+
+    while (live_map[h] && samples[live_map[h] - 1].bp != bp)
+        h = (h + 1) & (LIVE_SLOTS - 1);
+    if (!live_map[h])
+        return -1;
+    i = live_map[h] - 1;
+
+    /* 뒤따르는 항목을 당겨 탐사 사슬에 구멍이 생기지 않게 한다 */
+    for (j = h;;) {
+        live_map[j] = 0;
+        for (k = (j + 1) & (LIVE_SLOTS - 1);; k = (k + 1) & (LIVE_SLOTS - 1)) {
+            unsigned home;
+            if (!live_map[k])
+                return i;
+            home = live_hash(samples[live_map[k] - 1].bp);
+            /* k의 항목을 j로 옮겨도 되는가: home이 (j, k] 구간 밖에 있으면 */
+            if ((j < k) ? (home <= j || home > k) : (home <= j && home > k))
+                break;
+        }
+        live_map[j] = live_map[k];
+        j = k;
+    }
+}
+
+/* xorshift64* - uniform in (0, 1] */
+static double next_uniform(void)
+{
+    rng_state ^= rng_state >> 12;
+    rng_state ^= rng_state << 25;
+    rng_state ^= rng_state >> 27;
+    return ((rng_state * 0x2545f4914f6cdd1dull) >> 11) * (1.0 / 9007199254740992.0) +
+           (1.0 / 9007199254740992.0);
+}
+
+/* Draw the next countdown: exponential with mean interval */
+static void rearm(void)
+{
+    double gap;
+
+    if (interval == 0) {
+        mm_sample_bytes_left = LONG_MAX;
+        return;
+    }
+    gap = -log(next_uniform()) * (double)interval;
+    mm_sample_bytes_left = (gap >= (double)LONG_MAX) ? LONG_MAX : (long)gap;
+}
+
+/*
+ * mm_sample_set_interval - sample on average once every bytes allocated
+ *     bytes; 0 turns sampling off. Existing records are kept.
+ */
+void mm_sample_set_interval(size_t bytes)
+{
+    interval = bytes;
+    rearm();
+}
+
+/*
+ * mm_sample_reset - the heap was reset; forget every record
+ */
+void mm_sample_reset(void)
+{
+    nsamples = 0;
+    nlive = 0;
+    ndropped = 0;
+    dead_head = ndead = 0;
+    memset(live_map, 0, sizeof(live_map));
+    rearm();
+}
+
+/*
+ * mm_sample_record - remember a sampled block. Returns 1 if the block was
+ *     recorded (the caller then marks it), 0 if the buffer is full of live
+ *     samples. Dead records are reused oldest-first.
+ */
+int mm_sample_record(void *bp, size_t size, uint64_t opnum)
+{
+    struct timespec ts;
+    sample_t *s = NULL;
+    int i;
+
+    rearm();
+    if (nsamples < MM_SAMPLE_MAX) {
+        i = nsamples++;
+    } else if (ndead > 0) {
+        /* 가장 오래된 죽은 기록을 재활용 */
+        i = dead_ring[dead_head];
+        dead_head = (dead_head + 1) % MM_SAMPLE_MAX;
+        ndead--;
+    } else {
+        ndropped++;
+        return 0;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    s = &samples[i];
+    s->bp = bp;
+    s->size = size;
+    s->opnum = opnum;
+    s->nsec = (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+    s->weight = (double)size / (1.0 - exp(-(double)size / (double)interval));
+    s->live = 1;
+    live_insert(i);
+    nlive++;
+    return 1;
+}
+
+/*
+ * mm_sample_release - a sampled block was freed (or resized in place)
+ */
+void mm_sample_release(void *bp)
+{
+    int i = live_remove(bp);
+
+    if (i < 0)
+        return;
+    samples[i].live = 0;
+    nlive--;
+    dead_ring[(dead_head + ndead++) % MM_SAMPLE_MAX] = i;
+}
+
+typedef struct {
+    size_t size;
+    size_t n, n_live;
+    double bytes, live_bytes;
+    uint64_t first_op;
+} sample_row_t;
+
+static int cmp_row(const void *a, const void *b)
+{
+    const sample_row_t *x = a, *y = b;
+    if (x->live_bytes != y->live_bytes)
+        return (x->live_bytes < y->live_bytes) ? 1 : -1;
+    if (x->bytes != y->bytes)
+        return (x->bytes < y->bytes) ? 1 : -1;
+    return (x->size > y->size) - (x->size < y->size);
+}
+
+/*
+ * mm_sample_dump - print the sampled profile grouped by request size,
+ *     largest estimated live bytes first.
+ */
+void mm_sample_dump(FILE *fp)
+{
+    static sample_row_t rows[MM_SAMPLE_MAX];
+    int nrows = 0, i, j;
+    double total = 0, total_live = 0;
+
+    for (i = 0; i < nsamples; i++) {
+        sample_t *s = &samples[i];
+        for (j = 0; j < nrows && rows[j].size != s->size; j++)
+            ;
+        if (j == nrows) {
+            memset(&rows[j], 0, sizeof(rows[j]));
+            rows[j].size = s->size;
+            rows[j].first_op = s->opnum;
+            nrows++;
+        }
+        if (s->opnum < rows[j].first_op)
+            rows[j].first_op = s->opnum;
+        rows[j].n++;
+        rows[j].bytes += s->weight;
+        total += s->weight;
+        if (s->live) {
+            rows[j].n_live++;
+            rows[j].live_bytes += s->weight;
+            total_live += s->weight;
+        }
+    }
+    qsort(rows, nrows, sizeof(rows[0]), cmp_row);
+
+    fprintf(fp, "heap profile: interval=%zu samples=%d live=%d dropped=%zu"
+                " est_bytes=%.0f est_live=%.0f\n",
+            interval, nsamples, nlive, ndropped, total, total_live);
+    fprintf(fp, "%10s %8s %8s %12s %12s %10s\n",
+            "size", "samples", "live", "est_bytes", "est_live", "first_op");
+    for (i = 0; i < nrows && i < 20; i++)
+        fprintf(fp, "%10zu %8zu %8zu %12.0f %12.0f %10lu\n",
+                rows[i].size, rows[i].n, rows[i].n_live, rows[i].bytes,
+                rows[i].live_bytes, (unsigned long)rows[i].first_op);
+    if (nrows > 20)
+        fprintf(fp, "... (%d more sizes)\n", nrows - 20);
+}
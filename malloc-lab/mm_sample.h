@@ -0,0 +1,28 @@
+#ifndef __MM_SAMPLE_H_
+#define __MM_SAMPLE_H_
+
+/*
+ * mm_sample.h - byte-interval sampling heap profiler for the mm package
+ *
+ * 평균 interval 바이트마다 한 번(지수분포 간격) 할당을 표본으로 기록한다.
+ * 빠른 경로는 MM_SAMPLE_TICK의 뺄셈 + 분기 하나뿐이고, 표본이 된 블록은 mm.c가
+ * 헤더의 SAMPLED 비트로 표시해서 free 시에도 비트 검사 하나로 끝난다.
+ * 꺼져 있을 때(interval == 0)는 카운트다운이 사실상 줄어들지 않는 값으로 고정된다.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define MM_SAMPLE_MAX 4096          /* sample records kept per heap */
+
+extern long mm_sample_bytes_left;
+
+/* Count size bytes against the countdown; true when this allocation is sampled */
+#define MM_SAMPLE_TICK(size) \
+    (__builtin_expect((mm_sample_bytes_left -= (long)(size)) < 0, 0))
+
+void mm_sample_reset(void);
+int  mm_sample_record(void *bp, size_t size, uint64_t opnum);
+void mm_sample_release(void *bp);
+
+#endif /* __MM_SAMPLE_H_ */
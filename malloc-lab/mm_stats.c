@@ -0,0 +1,161 @@
+/*
+ * mm_stats.c - publish the mm package's counters in a shared-memory page
+ *
+ * 페이지는 한 번만 만들어지고(첫 mm_init), 그 뒤 할당 경로는 메모리 쓰기만 한다.
+ * 프로세스가 끝나면 shm 객체를 unlink한다.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+
+#include "mm_stats.h"
+
+static mm_stats_t local_stats = {
+    MM_STATS_MAGIC, MM_STATS_VERSION, 0, MM_STATS_NCLASS,
+};
+
+mm_stats_t *mm_stats = &local_stats;
+
+static char shm_name[64];
+
+static void mm_stats_detach(void)
+{
+    shm_unlink(shm_name);
+}
+
+/*
+ * mm_stats_attach - move the counters into /mm_stats.<pid> if MM_STATS_SHM
+ *     is set. Called from mm_init; only the first call does anything.
+ */
+void mm_stats_attach(void)
+{
+    static int attached = 0;
+    size_t len = (sizeof(mm_stats_t) + 4095) & ~(size_t)4095;
+    mm_stats_t *page;
+    int fd;
+
+    if (attached)
+        return;
+    attached = 1;
+    local_stats.pid = getpid();
+
+    if (getenv("MM_STATS_SHM") == NULL)
+        return;
+
+    snprintf(shm_name, sizeof(shm_name), MM_STATS_SHM_FMT, (int)getpid());
+    if ((fd = shm_open(shm_name, O_CREAT | O_RDWR | O_TRUNC, 0644)) < 0) {
+        perror("mm_stats: shm_open");
+        return;
+    }
+    if (ftruncate(fd, len) < 0) {
+        perror("mm_stats: ftruncate");
+        close(fd);
+        shm_unlink(shm_name);
+        return;
+    }
+    page = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (page == MAP_FAILED) {
+        perror("mm_stats: mmap");
+        shm_unlink(shm_name);
+        return;
+    }
+
+    memcpy(page, &local_stats, sizeof(local_stats));
+    mm_stats = page;
+    atexit(mm_stats_detach);
+}
+
+/*
+ * mm_stats_reset_gauges - the heap was reset; forget what it held
+ */
+void mm_stats_reset_gauges(void)
+{
+    int i;
+
+    MM_STAT_SET(live_bytes, 0);
+    MM_STAT_SET(heap_bytes, 0);
+    for (i = 0; i < MM_STATS_NCLASS; i++) {
+        MM_STAT_SET(class_free_bytes[i], 0);
+        MM_STAT_SET(class_free_blocks[i], 0);
+    }
+}
+
+static mm_shard_t shards[MM_SHARDS];
+static unsigned nshards = 0;               /* shards ever handed out */
+static unsigned free_shards[MM_SHARDS];    /* shards of exited threads */
+static unsigned nfree = 0;
+static pthread_mutex_t shard_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_key_t shard_key;
+static pthread_once_t shard_key_once = PTHREAD_ONCE_INIT;
+
+__thread mm_shard_t *mm_my_shard;
+
+/* 스레드가 끝나면 shard를 다음 스레드에 물려준다 (누적 값은 그대로 합계에 남음) */
+static void shard_release(void *arg)
+{
+    mm_shard_t *s = arg;
+
+    mm_my_shard = NULL;     /* 뒤에 도는 소멸자가 세면 새 shard를 받는다 */
+    pthread_mutex_lock(&shard_lock);
+    free_shards[nfree++] = s - shards;
+    pthread_mutex_unlock(&shard_lock);
+}
+
+static void make_shard_key(void)
+{
+    pthread_key_create(&shard_key, shard_release);
+}
+
+/*
+ * mm_shard_register - give the calling thread its own shard (the first use
+ *     of MM_SHARD_ADD in a thread ends up here), preferably one left by an
+ *     exited thread. Only when MM_SHARDS - 1 threads are alive at once do
+ *     the others share the last shard.
+ */
+mm_shard_t *mm_shard_register(void)
+{
+    unsigned i;
+
+    pthread_once(&shard_key_once, make_shard_key);
+    pthread_mutex_lock(&shard_lock);
+    if (nfree > 0)
+        i = free_shards[--nfree];
+    else if (nshards < MM_SHARDS - 1)
+        __atomic_store_n(&nshards, (i = nshards) + 1, __ATOMIC_RELEASE);
+    else
+        i = MM_SHARDS - 1;
+    pthread_mutex_unlock(&shard_lock);
+
+    mm_my_shard = &shards[i];
+    if (i == MM_SHARDS - 1) {
+        __atomic_store_n(&shards[i].shared, 1, __ATOMIC_RELAXED);
+        __atomic_store_n(&nshards, MM_SHARDS, __ATOMIC_RELEASE);
+    } else {
+        pthread_setspecific(shard_key, mm_my_shard);
+    }
+    return mm_my_shard;
+}
+
+/*
+ * mm_shard_sum - add up every shard. Each field is read untorn, but the
+ *     sum is not a snapshot of one instant.
+ */
+void mm_shard_sum(mm_shard_t *out)
+{
+    unsigned n = __atomic_load_n(&nshards, __ATOMIC_ACQUIRE);
+
+    memset(out, 0, sizeof(*out));
+    for (unsigned i = 0; i < n; i++) {
+        out->n_malloc += __atomic_load_n(&shards[i].n_malloc, __ATOMIC_RELAXED);
+        out->n_free += __atomic_load_n(&shards[i].n_free, __ATOMIC_RELAXED);
+        out->n_realloc += __atomic_load_n(&shards[i].n_realloc, __ATOMIC_RELAXED);
+        out->alloc_bytes += __atomic_load_n(&shards[i].alloc_bytes, __ATOMIC_RELAXED);
+        out->n_slow += __atomic_load_n(&shards[i].n_slow, __ATOMIC_RELAXED);
+        out->n_remote_free += __atomic_load_n(&shards[i].n_remote_free, __ATOMIC_RELAXED);
+    }
+}
@@ -0,0 +1,98 @@
+#ifndef __MM_STATS_H_
+#define __MM_STATS_H_
+
+/*
+ * mm_stats.h - live allocator counters, exported through shared memory
+ *
+ * mm 패키지는 mm_stats가 가리키는 페이지의 카운터를 갱신한다. 기본적으로는
+ * 프로세스 내부의 정적 페이지를 쓰고, 환경변수 MM_STATS_SHM이 설정된 채로
+ * mm_init이 처음 불리면 POSIX shared memory(/mm_stats.<pid>)로 옮겨서
+ * 외부의 mmstat 도구가 읽을 수 있게 한다.
+ *
+ * 쓰는 쪽은 할당기 하나뿐이므로 relaxed load + relaxed store로 갱신한다.
+ * (lock 접두사 없는 일반 add로 컴파일되며, 할당 경로에 syscall이 없다.)
+ * 읽는 쪽은 찢어지지 않은 64비트 값을 보지만 필드 간 스냅샷 일관성은 없다.
+ */
+
+#include <stdint.h>
+
+#define MM_STATS_MAGIC   0x6d6d7374u   /* "mmst" */
+#define MM_STATS_VERSION 1
+#define MM_STATS_NCLASS  16            /* == NLISTS in mm.c */
+#define MM_STATS_SHM_FMT "/mm_stats.%d"
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    int32_t  pid;
+    uint32_t nclass;
+
+    /* 누적 카운터 (mm_init이 다시 불려도 유지) */
+    uint64_t n_malloc;                 /* mm_malloc calls (size > 0) */
+    uint64_t n_free;                   /* mm_free calls (bp != NULL) */
+    uint64_t n_realloc;                /* mm_realloc calls */
+    uint64_t n_init;                   /* mm_init calls (heap resets) */
+    uint64_t n_extend;                 /* extend_heap calls */
+    uint64_t extend_bytes;             /* bytes added by extend_heap */
+
+    /* find_fit 탐색 길이 요약 */
+    uint64_t n_search;                 /* find_fit calls */
+    uint64_t search_steps;             /* free blocks examined, total */
+    uint64_t search_max;               /* longest single search */
+    uint64_t search_fail;              /* searches that found nothing */
+
+    /* 게이지 (mm_init에서 0으로 리셋) */
+    uint64_t live_bytes;               /* allocated block bytes incl. hdr/ftr */
+    uint64_t heap_bytes;               /* mem_heapsize() as seen by mm */
+    uint64_t class_free_bytes[MM_STATS_NCLASS];
+    uint64_t class_free_blocks[MM_STATS_NCLASS];
+} mm_stats_t;
+
+extern mm_stats_t *mm_stats;
+
+void mm_stats_attach(void);
+void mm_stats_reset_gauges(void);
+
+#define MM_STAT_LOAD(f)   __atomic_load_n(&mm_stats->f, __ATOMIC_RELAXED)
+#define MM_STAT_SET(f, v) __atomic_store_n(&mm_stats->f, (uint64_t)(v), __ATOMIC_RELAXED)
+#define MM_STAT_ADD(f, d) MM_STAT_SET(f, MM_STAT_LOAD(f) + (uint64_t)(d))
+#define MM_STAT_SUB(f, d) MM_STAT_SET(f, MM_STAT_LOAD(f) - (uint64_t)(d))
+#define MM_STAT_MAX(f, v) do { if ((uint64_t)(v) > MM_STAT_LOAD(f)) MM_STAT_SET(f, v); } while (0)
+
+/*
+ * Sharded counters for the multi-threaded engines
+ *
+ * 스레드마다 캐시 라인 하나짜리 shard를 배정받아 자기 shard에만 쓴다 (단일 writer라
+ * relaxed load + store, lock 접두사 없음). 다른 스레드의 갱신과 캐시 라인을 공유하지
+ * 않으므로 스레드 수가 늘어도 통계 비용이 그대로다. 합계는 읽을 때만 mm_shard_sum으로
+ * 모든 shard를 더해서 구한다. 끝난 스레드의 shard는 다음에 생기는 스레드가 물려받고,
+ * 동시에 살아 있는 스레드가 MM_SHARDS - 1을 넘을 때만 나머지가 마지막 shard를 함께
+ * 쓰며 그 shard만 atomic add로 갱신한다.
+ */
+#define MM_SHARDS 256
+
+typedef struct {
+    uint64_t n_malloc;                 /* allocation calls */
+    uint64_t n_free;                   /* free calls */
+    uint64_t n_realloc;                /* realloc calls */
+    uint64_t alloc_bytes;              /* bytes requested */
+    uint64_t n_slow;                   /* allocations off the fast path */
+    uint64_t n_remote_free;            /* frees of another thread's block */
+    uint64_t shared;                   /* 1 if several threads write this shard */
+} __attribute__((aligned(64))) mm_shard_t;
+
+extern __thread mm_shard_t *mm_my_shard;
+
+mm_shard_t *mm_shard_register(void);
+void mm_shard_sum(mm_shard_t *out);
+
+#define MM_SHARD() (mm_my_shard != NULL ? mm_my_shard : mm_shard_register())
+#define MM_SHARD_ADD(f, d) do {                                                 \
+        mm_shard_t *s_ = MM_SHARD();                                            \
+        if (__builtin_expect(s_->shared, 0))                                    \
+            __atomic_fetch_add(&s_->f, (uint64_t)(d), __ATOMIC_RELAXED);        \
+        else                                                                    \
+            __atomic_store_n(&s_->f, s_->f + (uint64_t)(d), __ATOMIC_RELAXED);  \
+    } while (0)
+
+#endif /* __MM_STATS_H_ */
@@ -0,0 +1,943 @@
+/*
+ * mmbench.c - micro-benchmarks for the mm package
+ *
+ * mdriver가 trace 전체의 처리량과 공간 효율을 재는 반면, mmbench는 특정 기능 하나의
+ * 효과를 따로 잰다. 각 벤치마크는 memlib 힙을 직접 초기화하고 mm_* 만 호출한다.
+ *
+ *   unix> ./mmbench                     # list benchmarks
+ *   unix> ./mmbench realloc-grow [reps]
+ *   unix> ./mmbench pointer-chase [nodes]
+ *   unix> ./mmbench engines [max-threads]
+ *   unix> ./mmbench handoff [max-threads]
+ *   unix> ./mmbench locks [max-threads]
+ *   unix> ./mmbench line-touch [megabytes]
+ *   unix> ./mmbench reorder [rounds]
+ *   unix> ./mmbench reserve-grow [megabytes]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <inttypes.h>
+
+#include "mm.h"
+#include "mm_page.h"
+#include "mm_lock.h"
+#include "memlib.h"
+
+#define LINE 64                       /* cache line size assumed by the benches */
+
+/*********************
+ * Helper routines
+ *********************/
+
+static double now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* Start every run from an empty heap */
+static void heap_reset(void)
+{
+    mem_reset_brk();
+    if (mm_init() < 0) {
+        fprintf(stderr, "mmbench: mm_init failed\n");
+        exit(1);
+    }
+}
+
+/* xorshift32 - deterministic workload shapes across runs */
+static unsigned rng = 2463534242u;
+static unsigned next_rand_r(unsigned *state)
+{
+    unsigned x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return *state = x;
+}
+static unsigned next_rand(void)
+{
+    return next_rand_r(&rng);
+}
+
+/* Read one byte per cache line; returns a sum so the loads are not dropped */
+static unsigned long touch_lines(const char *buf, size_t len)
+{
+    unsigned long sum = 0;
+    for (size_t i = 0; i < len; i += LINE)
+        sum += *(volatile const char *)(buf + i);
+    return sum;
+}
+
+/*********************
+ * realloc-grow
+ *********************/
+
+/*
+ * realloc-grow - move blocks of growing size with mm_realloc, once with plain
+ *     memcpy and once with streaming stores. For each size it reports the copy
+ *     bandwidth and how long re-reading a warm 256 KB working set takes right
+ *     after the copy (cache pollution), relative to not copying at all.
+ */
+static void bench_realloc_grow(int argc, char **argv)
+{
+    static const size_t sizes[] = { 64 << 10, 256 << 10, 1 << 20, 2 << 20, 4 << 20 };
+    static const struct { const char *name; size_t threshold; } modes[] = {
+        { "memcpy", (size_t)-1 },
+        { "stream", 0 },
+    };
+    const size_t wslen = 256 << 10;
+    int reps = (argc > 0) ? atoi(argv[0]) : 20;
+    char *ws = malloc(wslen);
+    unsigned long sink = 0;
+    double base = 0;
+
+    if (ws == NULL || reps <= 0) {
+        fprintf(stderr, "mmbench: realloc-grow [reps]\n");
+        exit(1);
+    }
+    memset(ws, 1, wslen);
+
+    /* 복사 없이 working set을 다시 읽는 비용 (기준선) */
+    for (int r = 0; r < reps; r++) {
+        sink += touch_lines(ws, wslen);
+        double t0 = now_sec();
+        sink += touch_lines(ws, wslen);
+        base += now_sec() - t0;
+    }
+    base /= reps;
+
+    printf("realloc-grow: %d reps, working set %zu KB, warm re-read %.1f us\n",
+           reps, wslen >> 10, base * 1e6);
+    printf("%-8s %10s %12s %14s %10s\n", "mode", "size(KB)", "copy(GB/s)", "ws-reread(us)", "vs warm");
+
+    for (size_t m = 0; m < sizeof(modes) / sizeof(modes[0]); m++) {
+        mm_copy_set_threshold(modes[m].threshold);
+        for (size_t k = 0; k < sizeof(sizes) / sizeof(sizes[0]); k++) {
+            size_t size = sizes[k];
+            double copy = 0, reread = 0;
+
+            for (int r = -1; r < reps; r++) {       /* r == -1: warm-up (page faults) */
+                heap_reset();
+                char *p = mm_malloc(size);
+                char *guard = mm_malloc(16);        /* 제자리 확장을 막아서 반드시 이동 */
+                if (p == NULL || guard == NULL) {
+                    fprintf(stderr, "mmbench: heap too small for %zu bytes\n", size);
+                    exit(1);
+                }
+                memset(p, 2, size);
+                sink += touch_lines(ws, wslen);
+                sink += touch_lines(ws, wslen);
+
+                double t0 = now_sec();
+                char *q = mm_realloc(p, 2 * size);
+                double t1 = now_sec();
+                sink += touch_lines(ws, wslen);
+                double t2 = now_sec();
+
+                if (q == NULL || q[size - 1] != 2) {
+                    fprintf(stderr, "mmbench: realloc lost data\n");
+                    exit(1);
+                }
+                if (r >= 0) {
+                    copy += t1 - t0;
+                    reread += t2 - t1;
+                }
+            }
+            printf("%-8s %10zu %12.2f %14.1f %9.2fx\n", modes[m].name, size >> 10,
+                   (double)size * reps / copy / 1e9, reread / reps * 1e6,
+                   reread / reps / base);
+        }
+    }
+    free(ws);
+    if (sink == 42)
+        printf("\n");
+}
+
+/*********************
+ * pointer-chase
+ *********************/
+
+typedef struct node {
+    struct node *next;
+    long payload[3];
+} node_t;
+
+/*
+ * pointer-chase - build a linked list on a fragmented heap while unrelated
+ *     allocations are interleaved, once with mm_malloc and once with
+ *     mm_malloc_near(prev), then time full traversals of each list.
+ */
+static void bench_pointer_chase(int argc, char **argv)
+{
+    int nodes = (argc > 0) ? atoi(argv[0]) : 40000;
+    const int nfiller = 60000, passes = 20;
+    static char *filler[60000];
+    static const char *names[] = { "mm_malloc", "mm_malloc_near" };
+    unsigned long sink = 0;
+
+    if (nodes <= 0) {
+        fprintf(stderr, "mmbench: pointer-chase [nodes]\n");
+        exit(1);
+    }
+    printf("pointer-chase: %d nodes of %zu bytes, %d traversals\n", nodes, sizeof(node_t), passes);
+    printf("%-16s %10s %14s %12s\n", "alloc", "ns/node", "avg hop (B)", "same page");
+
+    for (int mode = 0; mode < 2; mode++) {
+        node_t *head = NULL, *prev = NULL;
+        double hops = 0, t0, secs;
+        int same_page = 0;
+
+        heap_reset();
+        rng = 2463534242u;
+
+        /* 힙을 무작위 크기 블록으로 채우고 무작위로 절반을 풀어 구멍을 만든다 */
+        for (int i = 0; i < nfiller; i++)
+            filler[i] = mm_malloc(16 + next_rand() % 240);
+        for (int i = 0; i < nfiller; i++)
+            if (next_rand() & 1) {
+                mm_free(filler[i]);
+                filler[i] = NULL;
+            }
+
+        for (int i = 0; i < nodes; i++) {
+            node_t *n = (mode == 0 || prev == NULL) ? mm_malloc(sizeof(node_t))
+                                                    : mm_malloc_near(prev, sizeof(node_t));
+            if (n == NULL) {
+                fprintf(stderr, "mmbench: out of heap\n");
+                exit(1);
+            }
+            n->next = NULL;
+            if (prev != NULL) {
+                prev->next = n;
+                hops += labs((char *)n - (char *)prev);
+                same_page += ((unsigned long)n >> 12) == ((unsigned long)prev >> 12);
+            } else {
+                head = n;
+            }
+            prev = n;
+
+            /* 다른 코드의 할당이 섞여 들어옴 */
+            if (next_rand() % 4 == 0) {
+                int k = next_rand() % nfiller;
+                if (filler[k] != NULL) {
+                    mm_free(filler[k]);
+                    filler[k] = NULL;
+                } else {
+                    filler[k] = mm_malloc(16 + next_rand() % 240);
+                }
+            }
+        }
+
+        for (node_t *n = head; n != NULL; n = n->next)  /* warm-up */
+            sink += n->payload[0];
+        t0 = now_sec();
+        for (int p = 0; p < passes; p++)
+            for (node_t *n = head; n != NULL; n = n->next)
+                sink += n->payload[0];
+        secs = now_sec() - t0;
+
+        printf("%-16s %10.2f %14.0f %11.1f%%\n", names[mode],
+               secs * 1e9 / ((double)nodes * passes), hops / (nodes - 1),
+               100.0 * same_page / (nodes - 1));
+    }
+    if (sink == 42)
+        printf("\n");
+}
+
+/*********************
+ * engines
+ *********************/
+
+/*
+ * 엔진 비교용 vtable. mm.c 엔진은 스레드 안전하지 않으므로 여기서는
+ * 전역 mutex 하나로 감싸서 쓴다 (공정한 비교의 기준선).
+ */
+typedef struct {
+    const char *name;
+    int   (*init)(void);
+    void *(*malloc)(size_t);
+    void  (*free)(void *);
+} engine_t;
+
+static pthread_mutex_t seg_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static void *seg_malloc(size_t size)
+{
+    pthread_mutex_lock(&seg_lock);
+    void *p = mm_malloc(size);
+    pthread_mutex_unlock(&seg_lock);
+    return p;
+}
+
+static void seg_free(void *ptr)
+{
+    pthread_mutex_lock(&seg_lock);
+    mm_free(ptr);
+    pthread_mutex_unlock(&seg_lock);
+}
+
+static const engine_t engines[] = {
+    { "seg-list", mm_init, seg_malloc, seg_free },
+    { "page",     mp_init, mp_malloc,  mp_free },
+};
+
+typedef struct {
+    const engine_t *engine;
+    int id;
+    long ops;
+} worker_t;
+
+#define WORKER_SLOTS 2000
+
+/* Random alloc/free churn on a private set of slots; mostly small sizes */
+static void *engine_worker(void *arg)
+{
+    worker_t *w = arg;
+    const engine_t *e = w->engine;
+    unsigned state = 2463534242u + w->id * 7919;
+    char *slot[WORKER_SLOTS] = { 0 };
+
+    for (long i = 0; i < w->ops; i++) {
+        int k = next_rand_r(&state) % WORKER_SLOTS;
+        if (slot[k] != NULL) {
+            e->free(slot[k]);
+            slot[k] = NULL;
+        } else {
+            unsigned r = next_rand_r(&state);
+            size_t size = (r % 64 == 0) ? 1 + r % 8192 : 16 + r % 240;
+            if ((slot[k] = e->malloc(size)) == NULL) {
+                fprintf(stderr, "mmbench: %s out of heap\n", e->name);
+                exit(1);
+            }
+            slot[k][0] = (char)k;
+        }
+    }
+    for (int k = 0; k < WORKER_SLOTS; k++)
+        if (slot[k] != NULL)
+            e->free(slot[k]);
+    return NULL;
+}
+
+/* Run nthreads workers on a fresh heap; returns elapsed seconds */
+static double run_workers(const engine_t *e, int nthreads, long ops,
+                          void *(*fn)(void *), size_t *footprint)
+{
+    pthread_t tid[64];
+    worker_t w[64];
+    double t0;
+
+    mem_reset_brk();
+    if (e->init() < 0) {
+        fprintf(stderr, "mmbench: %s init failed\n", e->name);
+        exit(1);
+    }
+    t0 = now_sec();
+    for (int t = 0; t < nthreads; t++) {
+        w[t].engine = e;
+        w[t].id = t;
+        w[t].ops = ops;
+        pthread_create(&tid[t], NULL, fn, &w[t]);
+    }
+    for (int t = 0; t < nthreads; t++)
+        pthread_join(tid[t], NULL);
+    *footprint = mem_heapsize();
+    return now_sec() - t0;
+}
+
+/*
+ * engines - seg-list engine (behind one mutex) vs page engine, with
+ *     1, 2, 4, ... max-threads threads each doing the same private churn
+ */
+static void bench_engines(int argc, char **argv)
+{
+    int maxthreads = (argc > 0) ? atoi(argv[0]) : 8;
+    const long ops = 400000;
+
+    if (maxthreads <= 0 || maxthreads > 64) {
+        fprintf(stderr, "mmbench: engines [max-threads <= 64]\n");
+        exit(1);
+    }
+    printf("engines: %ld ops per thread, %d slots per thread\n", ops, WORKER_SLOTS);
+    printf("%-10s %8s %12s %14s\n", "engine", "threads", "Mops/s", "footprint(KB)");
+    for (int t = 1; t <= maxthreads; t *= 2) {
+        for (size_t e = 0; e < sizeof(engines) / sizeof(engines[0]); e++) {
+            size_t footprint;
+            double secs = run_workers(&engines[e], t, ops, engine_worker, &footprint);
+            printf("%-10s %8d %12.2f %14zu\n", engines[e].name, t,
+                   ops * t / secs / 1e6, footprint >> 10);
+        }
+    }
+
+    mm_shard_t st;
+    mp_stats(&st);
+    printf("page engine counters: %" PRIu64 " mallocs (%.2f%% slow path), %" PRIu64
+           " frees (%" PRIu64 " remote), %.1f MB requested\n",
+           st.n_malloc, st.n_malloc ? 100.0 * st.n_slow / st.n_malloc : 0.0,
+           st.n_free, st.n_remote_free, st.alloc_bytes / 1048576.0);
+}
+
+/*********************
+ * handoff
+ *********************/
+
+#define HANDOFF_OBJS 10000
+
+static pthread_barrier_t handoff_barrier;
+static int handoff_threads, handoff_rounds;
+
+static int page_init_keep(void)
+{
+    mp_set_release(0, 0);
+    return mp_init();
+}
+
+static int page_init_release(void)
+{
+    mp_set_release(25, 4);
+    return mp_init();
+}
+
+static const engine_t handoff_engines[] = {
+    { "seg-list",     mm_init,           seg_malloc, seg_free },
+    { "page",         page_init_keep,    mp_malloc,  mp_free },
+    { "page+release", page_init_release, mp_malloc,  mp_free },
+};
+
+/*
+ * Threads take turns: the active thread allocates a burst of small objects,
+ * then frees 90% of them at random. The survivors are freed on its next turn.
+ * Memory one thread freed is useless to the others unless the engine hands it
+ * back (Hoard's blowup case).
+ */
+static void *handoff_worker(void *arg)
+{
+    worker_t *w = arg;
+    const engine_t *e = w->engine;
+    unsigned state = 2463534242u + w->id * 7919;
+    static __thread char *objs[HANDOFF_OBJS];
+    int nkeep = 0;
+
+    for (int r = 0; r < handoff_rounds; r++) {
+        if (r % handoff_threads == w->id) {
+            for (int i = 0; i < nkeep; i++)
+                e->free(objs[i]);
+            for (int i = 0; i < HANDOFF_OBJS; i++) {
+                if ((objs[i] = e->malloc(16 + next_rand_r(&state) % 240)) == NULL) {
+                    fprintf(stderr, "mmbench: %s out of heap\n", e->name);
+                    exit(1);
+                }
+                objs[i][0] = (char)i;
+            }
+            nkeep = 0;
+            for (int i = 0; i < HANDOFF_OBJS; i++) {
+                if (next_rand_r(&state) % 10 == 0)
+                    objs[nkeep++] = objs[i];
+                else
+                    e->free(objs[i]);
+            }
+            w->ops += 2 * HANDOFF_OBJS;
+        }
+        pthread_barrier_wait(&handoff_barrier);
+    }
+    for (int i = 0; i < nkeep; i++)
+        e->free(objs[i]);
+    return NULL;
+}
+
+/*
+ * handoff - footprint and throughput of the round-robin burst pattern for
+ *     seg-list, page engine keeping its pages, and page engine with
+ *     Hoard-style release of mostly-empty pages to the global heap
+ */
+static void bench_handoff(int argc, char **argv)
+{
+    int maxthreads = (argc > 0) ? atoi(argv[0]) : 8;
+
+    if (maxthreads <= 0 || maxthreads > 64) {
+        fprintf(stderr, "mmbench: handoff [max-threads <= 64]\n");
+        exit(1);
+    }
+    printf("handoff: bursts of %d objects, 90%% freed per turn\n", HANDOFF_OBJS);
+    printf("%-14s %8s %12s %14s\n", "engine", "threads", "Mops/s", "footprint(KB)");
+    for (int t = 1; t <= maxthreads; t *= 2) {
+        handoff_threads = t;
+        handoff_rounds = 8 * t;
+        pthread_barrier_init(&handoff_barrier, NULL, t);
+        for (size_t e = 0; e < sizeof(handoff_engines) / sizeof(handoff_engines[0]); e++) {
+            size_t footprint;
+            double secs = run_workers(&handoff_engines[e], t, 0, handoff_worker, &footprint);
+            double ops = 2.0 * HANDOFF_OBJS * handoff_rounds;
+            printf("%-14s %8d %12.2f %14zu\n", handoff_engines[e].name, t,
+                   ops / secs / 1e6, footprint >> 10);
+        }
+        pthread_barrier_destroy(&handoff_barrier);
+    }
+    mp_set_release(25, 4);
+}
+
+/*********************
+ * locks
+ *********************/
+
+/*
+ * 같은 seg-list 엔진을 pthread_mutex와 mm_lock으로 각각 감싼다.
+ * mutex 쪽도 mm_lock과 같은 방식으로 대기/점유 시간을 잰다.
+ */
+static pthread_mutex_t central_mutex = PTHREAD_MUTEX_INITIALIZER;
+static mm_lock_t central_lock = MM_LOCK_INITIALIZER;
+static mm_lock_stats_t mutex_stats;
+static uint64_t mutex_acquired;
+
+static void mutex_enter(void)
+{
+    uint64_t t0 = mm_lock_now();
+
+    if (pthread_mutex_trylock(&central_mutex) != 0) {
+        pthread_mutex_lock(&central_mutex);
+        mutex_stats.contended++;
+    }
+    mutex_acquired = mm_lock_now();
+    mutex_stats.acquire++;
+    mutex_stats.wait_ns += mutex_acquired - t0;
+    if (mutex_acquired - t0 > mutex_stats.wait_max)
+        mutex_stats.wait_max = mutex_acquired - t0;
+}
+
+static void mutex_exit(void)
+{
+    uint64_t hold = mm_lock_now() - mutex_acquired;
+
+    mutex_stats.hold_ns += hold;
+    if (hold > mutex_stats.hold_max)
+        mutex_stats.hold_max = hold;
+    pthread_mutex_unlock(&central_mutex);
+}
+
+static void *mutex_malloc(size_t size)
+{
+    mutex_enter();
+    void *p = mm_malloc(size);
+    mutex_exit();
+    return p;
+}
+
+static void mutex_free(void *ptr)
+{
+    mutex_enter();
+    mm_free(ptr);
+    mutex_exit();
+}
+
+static void *lock_malloc(size_t size)
+{
+    mm_lock(&central_lock);
+    void *p = mm_malloc(size);
+    mm_unlock(&central_lock);
+    return p;
+}
+
+static void lock_free(void *ptr)
+{
+    mm_lock(&central_lock);
+    mm_free(ptr);
+    mm_unlock(&central_lock);
+}
+
+static int mutex_init(void)
+{
+    memset(&mutex_stats, 0, sizeof(mutex_stats));
+    return mm_init();
+}
+
+static int lock_init(void)
+{
+    mm_lock_init(&central_lock);
+    return mm_init();
+}
+
+static const engine_t lock_engines[] = {
+    { "pthread_mutex", mutex_init, mutex_malloc, mutex_free },
+    { "mm_lock",       lock_init,  lock_malloc,  lock_free },
+    { "page",          mp_init,    mp_malloc,    mp_free },
+};
+
+static void print_lock_row(const char *name, int threads, double mops,
+                           const mm_lock_stats_t *st)
+{
+    double n = st->acquire ? (double)st->acquire : 1.0;
+
+    printf("%-14s %8d %10.2f %10.1f%% %8" PRIu64 " %10.0f %10.0f %10.1f %10.1f\n",
+           name, threads, mops, 100.0 * st->contended / n, st->sleeps,
+           st->wait_ns / n, st->hold_ns / n, st->wait_max / 1e3, st->hold_max / 1e3);
+}
+
+/*
+ * locks - scalability sweep of the central heap lock: seg-list behind
+ *     pthread_mutex vs behind mm_lock, plus the page engine's pool and
+ *     per-class locks, with mean wait/hold times per acquisition
+ */
+static void bench_locks(int argc, char **argv)
+{
+    int maxthreads = (argc > 0) ? atoi(argv[0]) : 8;
+    const long ops = 400000;
+
+    if (maxthreads <= 0 || maxthreads > 64) {
+        fprintf(stderr, "mmbench: locks [max-threads <= 64]\n");
+        exit(1);
+    }
+    mm_lock_set_timing(1);
+    printf("locks: %ld ops per thread, %ld online CPUs\n", ops, sysconf(_SC_NPROCESSORS_ONLN));
+    printf("%-14s %8s %10s %11s %8s %10s %10s %10s %10s\n", "lock", "threads", "Mops/s",
+           "contended", "sleeps", "wait(ns)", "hold(ns)", "wmax(us)", "hmax(us)");
+    for (int t = 1; t <= maxthreads; t *= 2) {
+        for (size_t e = 0; e < sizeof(lock_engines) / sizeof(lock_engines[0]); e++) {
+            const engine_t *eng = &lock_engines[e];
+            size_t footprint;
+            double mops = ops * t / run_workers(eng, t, ops, engine_worker, &footprint) / 1e6;
+
+            if (eng->malloc == mutex_malloc) {
+                print_lock_row(eng->name, t, mops, &mutex_stats);
+            } else if (eng->malloc == lock_malloc) {
+                print_lock_row(eng->name, t, mops, &central_lock.stats);
+            } else {
+                mm_lock_stats_t pool_st, class_st;
+                mp_lock_stats(&pool_st, &class_st);
+                print_lock_row("page/pool", t, mops, &pool_st);
+                print_lock_row("page/class", t, mops, &class_st);
+            }
+        }
+    }
+    mm_lock_set_timing(0);
+}
+
+/*********************
+ * line-touch
+ *********************/
+
+/*
+ * line-touch - allocate medium objects among small fillers, once with the
+ *     default 8-byte placement and once with mm_align_set, then read every
+ *     object in full in a random order. For each size it reports how many
+ *     objects straddle an extra cache line, the time per object and the
+ *     heap utilization (live payload / heap size), i.e. what the aligned
+ *     placement buys in access speed and what it costs in space.
+ */
+static void bench_line_touch(int argc, char **argv)
+{
+    static const size_t sizes[] = { 64, 96, 128, 192, 256 };
+    static const char *names[] = { "8-byte", "64-byte" };
+    const int passes = 10;
+    long mb = (argc > 0) ? atol(argv[0]) : 8;
+    unsigned long sink = 0;
+
+    if (mb <= 0 || mb > 8) {
+        fprintf(stderr, "mmbench: line-touch [megabytes] (1..8)\n");
+        exit(1);
+    }
+    printf("line-touch: %ld MB of objects per size, random order, %d passes\n", mb, passes);
+    printf("%6s %-8s %10s %10s %9s %7s\n",
+           "size", "align", "straddle", "lines/obj", "ns/obj", "util");
+
+    for (size_t k = 0; k < sizeof(sizes) / sizeof(sizes[0]); k++) {
+        size_t size = sizes[k];
+        int n = (int)((mb << 20) / size);
+        char **obj = malloc(n * sizeof(char *));
+        int *order = malloc(n * sizeof(int));
+
+        if (obj == NULL || order == NULL) {
+            fprintf(stderr, "mmbench: out of memory\n");
+            exit(1);
+        }
+        for (int mode = 0; mode < 2; mode++) {
+            size_t live = 0, lines = 0;
+            int straddle = 0;
+            double t0, secs;
+
+            heap_reset();
+            mm_align_set(mode ? size : 0, size);
+            rng = 2463534242u;
+
+            /* 작은 객체가 사이사이 끼어 정렬을 흩뜨리고, 절반은 곧 죽는다 */
+            for (int i = 0; i < n; i++) {
+                size_t filler_size = 8 + next_rand() % 48;
+                char *filler = mm_malloc(filler_size);
+                if ((obj[i] = mm_malloc(size)) == NULL || filler == NULL) {
+                    fprintf(stderr, "mmbench: out of heap\n");
+                    exit(1);
+                }
+                memset(obj[i], i, size);
+                if (next_rand() & 1)
+                    mm_free(filler);
+                else
+                    live += filler_size;
+                live += size;
+            }
+            for (int i = 0; i < n; i++) {
+                uintptr_t lo = (uintptr_t)obj[i] / LINE;
+                uintptr_t hi = ((uintptr_t)obj[i] + size - 1) / LINE;
+                lines += hi - lo + 1;
+                straddle += (hi - lo + 1) > (size + LINE - 1) / LINE;
+                order[i] = i;
+            }
+            for (int i = n - 1; i > 0; i--) {
+                int j = next_rand() % (i + 1), t = order[i];
+                order[i] = order[j];
+                order[j] = t;
+            }
+
+            t0 = now_sec();
+            for (int p = 0; p < passes; p++)
+                for (int i = 0; i < n; i++) {
+                    const long *w = (const long *)obj[order[i]];
+                    for (size_t b = 0; b < size / sizeof(long); b++)
+                        sink += w[b];
+                }
+            secs = now_sec() - t0;
+
+            printf("%6zu %-8s %9.1f%% %10.2f %9.2f %6.1f%%\n", size, names[mode],
+                   100.0 * straddle / n, (double)lines / n,
+                   secs * 1e9 / ((double)n * passes),
+                   100.0 * live / mem_heapsize());
+        }
+        free(obj);
+        free(order);
+    }
+    mm_align_set(0, 0);
+    if (sink == 42)
+        printf("\n");
+}
+
+/*********************
+ * reorder
+ *********************/
+
+/*
+ * reorder - objects of one size sit between small live pins, so freed
+ *     objects never coalesce and stay on the exact-size run of their class
+ *     list. Random churn frees and reallocates them, which leaves the run in
+ *     random address order; then a batch of same-sized allocations is timed
+ *     for locality (distance between consecutive blocks). Three policies:
+ *     plain LIFO lists, reordering on the heap-growth slow path
+ *     (mm_reorder_set_budget) and idle passes (mm_reorder_step) after the
+ *     churn.
+ */
+static void bench_reorder(int argc, char **argv)
+{
+    static const char *names[] = { "lifo", "on grow (256)", "idle passes" };
+    static char *obj[40000];
+    static char *run[4000];
+    const int nobj = 40000, nrun = 4000;
+    const size_t size = 160;
+    long rounds = (argc > 0) ? atol(argv[0]) : 400000;
+
+    if (rounds <= 0) {
+        fprintf(stderr, "mmbench: reorder [rounds]\n");
+        exit(1);
+    }
+    printf("reorder: %d pinned %zu-byte objects, %ld churn ops, then a run of %d\n",
+           nobj, size, rounds, nrun);
+    printf("%-12s %10s %11s %13s %11s %10s\n",
+           "policy", "churn Mops", "reorder ms", "avg hop (B)", "same page", "ascending");
+
+    for (int mode = 0; mode < 3; mode++) {
+        double t0, churn, reorder = 0, hops = 0;
+        int same_page = 0, ascending = 0;
+
+        heap_reset();
+        rng = 2463534242u;
+        for (int i = 0; i < nobj; i++) {
+            obj[i] = mm_malloc(size);
+            /* pin은 warm 리스트 밖의 크기여야 객체 사이에 하나씩 놓인다 */
+            if (mm_malloc(136) == NULL || obj[i] == NULL) {
+                fprintf(stderr, "mmbench: out of heap\n");
+                exit(1);
+            }
+        }
+
+        mm_reorder_set_budget(mode == 1 ? 256 : 0);
+        t0 = now_sec();
+        for (long r = 0; r < rounds; r++) {
+            int k = next_rand() % nobj;
+            if (obj[k] != NULL) {
+                mm_free(obj[k]);
+                obj[k] = NULL;
+            } else {
+                obj[k] = mm_malloc(size);
+            }
+        }
+        churn = now_sec() - t0;
+        mm_reorder_set_budget(0);
+
+        if (mode == 2) {
+            /* 한가할 때: 리스트 전체를 몇 바퀴 */
+            t0 = now_sec();
+            for (int pass = 0; pass < 8; pass++)
+                mm_reorder_step(nobj);
+            reorder = now_sec() - t0;
+        }
+
+        for (int i = 0; i < nrun; i++) {
+            if ((run[i] = mm_malloc(size)) == NULL) {
+                fprintf(stderr, "mmbench: out of heap\n");
+                exit(1);
+            }
+            if (i > 0) {
+                hops += labs(run[i] - run[i - 1]);
+                same_page += ((unsigned long)run[i] >> 12) == ((unsigned long)run[i - 1] >> 12);
+                ascending += run[i] > run[i - 1];
+            }
+        }
+
+        printf("%-12s %10.2f ", names[mode], rounds / churn / 1e6);
+        if (mode == 1)
+            printf("%11s ", "(in churn)");
+        else
+            printf("%11.2f ", reorder * 1e3);
+        printf("%13.0f %10.1f%% %9.1f%%\n", hops / (nrun - 1),
+               100.0 * same_page / (nrun - 1), 100.0 * ascending / (nrun - 1));
+        mm_checkheap(__LINE__);
+        if (mm_check_errors() != 0) {
+            fprintf(stderr, "mmbench: heap check failed\n");
+            exit(1);
+        }
+    }
+}
+
+/**************
+ * Main routine
+ **************/
+
+typedef struct {
+    const char *name;
+    const char *args;
+    void (*run)(int argc, char **argv);
+} bench_t;
+
+/*********************
+ * reserve-grow
+ *********************/
+
+/*
+ * reserve-grow - append 100-byte records to a log buffer until it holds
+ *     the given size, once as a heap block that doubles with mm_realloc and
+ *     once as an mm_reserve buffer extended with mm_grow. Small long-lived
+ *     objects are allocated between appends, so the heap block cannot always
+ *     grow in place. Reports moves, bytes copied and time per append.
+ */
+static void bench_reserve_grow(int argc, char **argv)
+{
+    static const char *names[] = { "realloc", "reserve" };
+    const size_t rec = 100;
+    long mb = (argc > 0) ? atol(argv[0]) : 4;
+    size_t max = (size_t)mb << 20;
+    char record[100];
+
+    if (mb <= 0 || mb > 6) {
+        fprintf(stderr, "mmbench: reserve-grow [megabytes] (1..6)\n");
+        exit(1);
+    }
+    memset(record, 'x', sizeof(record));
+    printf("reserve-grow: %zu-byte records up to %ld MB, a 32-byte object every 64 appends\n",
+           rec, mb);
+    printf("%-8s %10s %8s %12s %10s %11s\n",
+           "mode", "appends", "moves", "copied(MB)", "ms", "ns/append");
+
+    for (int mode = 0; mode < 2; mode++) {
+        size_t len = 0, cap = 0, copied = 0;
+        long appends = 0, moves = 0;
+        char *buf = NULL;
+        double t0, secs;
+
+        heap_reset();
+        t0 = now_sec();
+        if (mode == 1 && (buf = mm_reserve(max)) == NULL) {
+            fprintf(stderr, "mmbench: mm_reserve failed\n");
+            exit(1);
+        }
+        while (len + rec <= max) {
+            if (len + rec > cap) {
+                if (mode == 0) {
+                    size_t ncap = cap ? 2 * cap : 4096;
+                    char *p = mm_realloc(buf, ncap);
+                    if (p == NULL) {
+                        fprintf(stderr, "mmbench: out of heap\n");
+                        exit(1);
+                    }
+                    if (buf != NULL && p != buf) {
+                        moves++;
+                        copied += len;
+                    }
+                    buf = p;
+                    cap = ncap;
+                } else {
+                    if (mm_grow(buf, len + rec) != 0) {
+                        fprintf(stderr, "mmbench: mm_grow failed\n");
+                        exit(1);
+                    }
+                    cap = len + rec;
+                }
+            }
+            memcpy(buf + len, record, rec);
+            len += rec;
+            if (++appends % 64 == 0 && mm_malloc(32) == NULL) {
+                fprintf(stderr, "mmbench: out of heap\n");
+                exit(1);
+            }
+        }
+        secs = now_sec() - t0;
+        if (buf[0] != 'x' || buf[len - 1] != 'x') {
+            fprintf(stderr, "mmbench: log buffer lost data\n");
+            exit(1);
+        }
+        if (mode == 0)
+            mm_free(buf);
+        else
+            mm_release(buf);
+        printf("%-8s %10ld %8ld %12.1f %10.2f %11.1f\n", names[mode], appends, moves,
+               copied / 1048576.0, secs * 1e3, secs * 1e9 / appends);
+    }
+}
+
+static const bench_t benches[] = {
+    { "realloc-grow", "[reps]", bench_realloc_grow },
+    { "pointer-chase", "[nodes]", bench_pointer_chase },
+    { "engines", "[max-threads]", bench_engines },
+    { "handoff", "[max-threads]", bench_handoff },
+    { "locks", "[max-threads]", bench_locks },
+    { "line-touch", "[megabytes]", bench_line_touch },
+    { "reorder", "[rounds]", bench_reorder },
+    { "reserve-grow", "[megabytes]", bench_reserve_grow },
+    { NULL, NULL, NULL },
+};
+
+static void usage(void)
+{
+    fprintf(stderr, "Usage: mmbench <benchmark> [args]\n");
+    fprintf(stderr, "Benchmarks\n");
+    for (const bench_t *b = benches; b->name != NULL; b++)
+        fprintf(stderr, "\t%-14s %s\n", b->name, b->args);
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2) {
+        usage();
+        exit(1);
+    }
+    for (const bench_t *b = benches; b->name != NULL; b++) {
+        if (strcmp(argv[1], b->name) == 0) {
+            mem_init();
+            b->run(argc - 2, argv + 2);
+            mem_deinit();
+            exit(0);
+        }
+    }
+    usage();
+    exit(1);
+}
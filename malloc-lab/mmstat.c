@@ -0,0 +1,148 @@
+/*
+ * mmstat.c - report live mm package statistics, in the style of vmstat
+ *
+ * mm 패키지를 쓰는 프로세스를 MM_STATS_SHM=1 로 띄우면 /mm_stats.<pid> 페이지가
+ * 생긴다. mmstat은 그 페이지를 읽기 전용으로 매핑하고 interval마다 차이를 출력한다.
+ *
+ *   unix> MM_STATS_SHM=1 ./mdriver -a &
+ *   unix> ./mmstat $! 1
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "mm_stats.h"
+
+static void usage(void)
+{
+    fprintf(stderr, "Usage: mmstat [-c] <pid> [interval [count]]\n");
+    fprintf(stderr, "Options\n");
+    fprintf(stderr, "\t-c         Also print per-class free bytes.\n");
+}
+
+/* snapshot - copy the counters out of the shared page field by field */
+static void snapshot(const mm_stats_t *shm, mm_stats_t *out)
+{
+    const uint64_t *src = (const uint64_t *)&shm->n_malloc;
+    uint64_t *dst = (uint64_t *)&out->n_malloc;
+    size_t i, n = (sizeof(mm_stats_t) - offsetof(mm_stats_t, n_malloc)) / sizeof(uint64_t);
+
+    memcpy(out, shm, offsetof(mm_stats_t, n_malloc));
+    for (i = 0; i < n; i++)
+        dst[i] = __atomic_load_n(&src[i], __ATOMIC_RELAXED);
+}
+
+static void print_header(int per_class)
+{
+    int i;
+
+    printf("%9s %9s %9s %10s %10s %6s %8s %6s %7s\n",
+           "malloc/s", "free/s", "realloc/s", "live(KB)", "heap(KB)",
+           "ext/s", "avgsrch", "maxsrch", "fail/s");
+    if (per_class) {
+        printf("  free KB by class:");
+        for (i = 0; i < MM_STATS_NCLASS; i++)
+            printf(" %5d", i);
+        printf("\n");
+    }
+}
+
+int main(int argc, char **argv)
+{
+    int c, fd, per_class = 0;
+    pid_t pid;
+    unsigned interval = 1;
+    long count = -1;
+    char name[64];
+    mm_stats_t *shm, prev, cur;
+    long row;
+
+    while ((c = getopt(argc, argv, "ch")) != EOF) {
+        switch (c) {
+        case 'c':
+            per_class = 1;
+            break;
+        case 'h':
+            usage();
+            exit(0);
+        default:
+            usage();
+            exit(1);
+        }
+    }
+    if (optind >= argc) {
+        usage();
+        exit(1);
+    }
+    pid = atoi(argv[optind++]);
+    if (optind < argc)
+        interval = atoi(argv[optind++]);
+    if (optind < argc)
+        count = atol(argv[optind++]);
+    if (interval == 0)
+        interval = 1;
+
+    snprintf(name, sizeof(name), MM_STATS_SHM_FMT, (int)pid);
+    if ((fd = shm_open(name, O_RDONLY, 0)) < 0) {
+        fprintf(stderr, "mmstat: cannot open %s: %s (was it started with MM_STATS_SHM=1?)\n",
+                name, strerror(errno));
+        exit(1);
+    }
+    shm = mmap(NULL, sizeof(mm_stats_t), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (shm == MAP_FAILED) {
+        fprintf(stderr, "mmstat: mmap: %s\n", strerror(errno));
+        exit(1);
+    }
+    if (shm->magic != MM_STATS_MAGIC || shm->version != MM_STATS_VERSION) {
+        fprintf(stderr, "mmstat: %s is not a version %d stats page\n",
+                name, MM_STATS_VERSION);
+        exit(1);
+    }
+
+    snapshot(shm, &prev);
+    for (row = 0; count < 0 || row < count; row++) {
+        uint64_t searches, steps;
+        int i;
+
+        sleep(interval);
+        if (kill(pid, 0) < 0 && errno == ESRCH) {
+            printf("mmstat: process %d exited\n", (int)pid);
+            break;
+        }
+        snapshot(shm, &cur);
+
+        if (row % 20 == 0)
+            print_header(per_class);
+
+        searches = cur.n_search - prev.n_search;
+        steps = cur.search_steps - prev.search_steps;
+        printf("%9.0f %9.0f %9.0f %10.1f %10.1f %6.0f %8.1f %6lu %7.0f\n",
+               (double)(cur.n_malloc - prev.n_malloc) / interval,
+               (double)(cur.n_free - prev.n_free) / interval,
+               (double)(cur.n_realloc - prev.n_realloc) / interval,
+               cur.live_bytes / 1024.0,
+               cur.heap_bytes / 1024.0,
+               (double)(cur.n_extend - prev.n_extend) / interval,
+               searches ? (double)steps / searches : 0.0,
+               (unsigned long)cur.search_max,
+               (double)(cur.search_fail - prev.search_fail) / interval);
+        if (per_class) {
+            printf("  %17s", "");
+            for (i = 0; i < MM_STATS_NCLASS; i++)
+                printf(" %5.0f", cur.class_free_bytes[i] / 1024.0);
+            printf("\n");
+        }
+        prev = cur;
+    }
+
+    munmap(shm, sizeof(mm_stats_t));
+    exit(0);
+}
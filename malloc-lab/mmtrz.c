@@ -0,0 +1,219 @@
+/*
+ * mmtrz.c - convert traces to and from the compressed container (tracez.h)
+ *
+ * mdriver은 .repz 파일을 그대로 읽으므로 (-f, -t), 큰 trace는 한 번 변환해 두면
+ * 디스크에서 읽는 바이트가 줄어든다. t 명령은 풀기 속도를 잰다.
+ *
+ *   unix> ./mmtrz c traces/realloc-bal.rep realloc-bal.repz
+ *   unix> ./mmtrz d realloc-bal.repz > realloc-bal.rep
+ *   unix> ./mmtrz t realloc-bal.repz [reps]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "tracez.h"
+
+#define BATCH 4096                     /* ops per tz_read call */
+
+static void usage(void)
+{
+    fprintf(stderr, "Usage: mmtrz c <in.rep> <out.repz>\n");
+    fprintf(stderr, "       mmtrz d <in.repz>\n");
+    fprintf(stderr, "       mmtrz t <in.repz> [reps]\n");
+    fprintf(stderr, "Commands\n");
+    fprintf(stderr, "\tc          Compress a text trace.\n");
+    fprintf(stderr, "\td          Print a compressed trace as text.\n");
+    fprintf(stderr, "\tt          Time decompression into an op array.\n");
+}
+
+static FILE *open_or_die(const char *path, const char *mode)
+{
+    FILE *fp = fopen(path, mode);
+
+    if (fp == NULL) {
+        perror(path);
+        exit(1);
+    }
+    return fp;
+}
+
+static double now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* Length of op as a line of a .rep file, e.g. "a 12 2040\n" */
+static size_t text_len(const tz_op_t *op)
+{
+    char line[40];
+
+    if (op->type == TZ_FREE)
+        return snprintf(line, sizeof(line), "f %u\n", op->id);
+    return snprintf(line, sizeof(line), "a %u %u\n", op->id, op->size);
+}
+
+static int compress(const char *in, const char *out)
+{
+    FILE *src = open_or_die(in, "r"), *dst;
+    tz_writer_t w;
+    tz_header_t h;
+    tz_op_t op;
+    char type[16];
+    long text, nops = 0;
+
+    if (fscanf(src, "%d %d %d %d", &h.sugg_heapsize, &h.num_ids,
+               &h.num_ops, &h.weight) != 4) {
+        fprintf(stderr, "mmtrz: %s: bad trace header\n", in);
+        return 1;
+    }
+    dst = open_or_die(out, "wb");
+    if (tz_create(&w, dst, &h) != 0) {
+        fprintf(stderr, "mmtrz: cannot write %s\n", out);
+        return 1;
+    }
+    while (fscanf(src, "%15s", type) == 1) {
+        op.size = 0;
+        switch (type[0]) {
+        case 'a':
+            op.type = TZ_ALLOC;
+            if (fscanf(src, "%u %u", &op.id, &op.size) != 2) goto bad;
+            break;
+        case 'r':
+            op.type = TZ_REALLOC;
+            if (fscanf(src, "%u %u", &op.id, &op.size) != 2) goto bad;
+            break;
+        case 'f':
+            op.type = TZ_FREE;
+            if (fscanf(src, "%u", &op.id) != 1) goto bad;
+            break;
+        default:
+            goto bad;
+        }
+        if (tz_write(&w, &op) != 0) {
+            fprintf(stderr, "mmtrz: cannot write %s\n", out);
+            return 1;
+        }
+        nops++;
+    }
+    text = ftell(src);
+    if (tz_finish(&w) != 0 || fclose(dst) != 0) {
+        fprintf(stderr, "mmtrz: cannot write %s\n", out);
+        return 1;
+    }
+    fclose(src);
+    if (nops != h.num_ops)
+        fprintf(stderr, "mmtrz: warning: %s has %ld ops, header says %d\n",
+                in, nops, h.num_ops);
+    printf("%s: %ld ops, text %ld B, records %llu B, container %llu B (%.1fx)\n",
+           out, nops, text, (unsigned long long)w.raw_total,
+           (unsigned long long)w.comp_total, (double)text / w.comp_total);
+    return 0;
+
+bad:
+    fprintf(stderr, "mmtrz: %s: bad request after op %ld\n", in, nops);
+    return 1;
+}
+
+static int decompress(const char *in)
+{
+    FILE *src = open_or_die(in, "rb");
+    tz_reader_t r;
+    tz_header_t h;
+    tz_op_t *ops = malloc(BATCH * sizeof(tz_op_t));
+    int n;
+
+    if (ops == NULL || tz_open(&r, src, &h) != 0) {
+        fprintf(stderr, "mmtrz: %s: not a compressed trace\n", in);
+        return 1;
+    }
+    printf("%d\n%d\n%d\n%d\n", h.sugg_heapsize, h.num_ids, h.num_ops, h.weight);
+    while ((n = tz_read(&r, ops, BATCH)) > 0) {
+        for (int i = 0; i < n; i++) {
+            if (ops[i].type == TZ_FREE)
+                printf("f %u\n", ops[i].id);
+            else
+                printf("%c %u %u\n", ops[i].type == TZ_ALLOC ? 'a' : 'r',
+                       ops[i].id, ops[i].size);
+        }
+    }
+    tz_close(&r);
+    fclose(src);
+    free(ops);
+    if (n < 0) {
+        fprintf(stderr, "mmtrz: %s: corrupt block\n", in);
+        return 1;
+    }
+    return 0;
+}
+
+/*
+ * time_decode - decode the whole file reps times into one op array, the
+ *     way mdriver loads it; the first pass also sizes the equivalent text
+ *     so the rate can be compared with parsing the .rep
+ */
+static int time_decode(const char *in, int reps)
+{
+    FILE *src = open_or_die(in, "rb");
+    tz_reader_t r;
+    tz_header_t h;
+    tz_op_t *ops;
+    long file_bytes, text = 0;
+    double secs = 0;
+    int n, total;
+
+    fseek(src, 0, SEEK_END);
+    file_bytes = ftell(src);
+    rewind(src);
+    if (tz_open(&r, src, &h) != 0) {
+        fprintf(stderr, "mmtrz: %s: not a compressed trace\n", in);
+        return 1;
+    }
+    tz_close(&r);
+    if ((ops = malloc((size_t)h.num_ops * sizeof(tz_op_t) + BATCH * sizeof(tz_op_t))) == NULL) {
+        fprintf(stderr, "mmtrz: out of memory\n");
+        return 1;
+    }
+
+    for (int rep = -1; rep < reps; rep++) {       /* rep == -1: warm-up, sizes the text */
+        rewind(src);
+        double t0 = now_sec();
+        tz_open(&r, src, &h);
+        total = 0;
+        while ((n = tz_read(&r, ops + total, BATCH)) > 0)
+            total += n;
+        tz_close(&r);
+        if (rep >= 0)
+            secs += now_sec() - t0;
+        if (n < 0 || total != h.num_ops) {
+            fprintf(stderr, "mmtrz: %s: corrupt or short trace\n", in);
+            return 1;
+        }
+        if (rep < 0)
+            for (int i = 0; i < total; i++)
+                text += text_len(&ops[i]);
+    }
+    secs /= reps;
+    printf("%s: %d ops, %ld B on disk, %.2f ms per load\n", in, h.num_ops, file_bytes, secs * 1e3);
+    printf("  %.0f Mops/s, %.2f GB/s of container, %.2f GB/s of equivalent text\n",
+           h.num_ops / secs / 1e6, file_bytes / secs / 1e9, text / secs / 1e9);
+    fclose(src);
+    free(ops);
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc == 4 && strcmp(argv[1], "c") == 0)
+        return compress(argv[2], argv[3]);
+    if (argc == 3 && strcmp(argv[1], "d") == 0)
+        return decompress(argv[2]);
+    if ((argc == 3 || argc == 4) && strcmp(argv[1], "t") == 0 &&
+        (argc == 3 || atoi(argv[3]) > 0))
+        return time_decode(argv[2], argc == 4 ? atoi(argv[3]) : 20);
+    usage();
+    return 1;
+}
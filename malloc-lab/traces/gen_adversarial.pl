@@ -0,0 +1,160 @@
+#!/usr/bin/perl
+#!/usr/local/bin/perl
+
+# Adversarial traces for the segregated-fit allocator in mm.c.
+#
+#   ./gen_adversarial.pl                 all patterns
+#   ./gen_adversarial.pl <pattern> ...   coalesce, boundary, sawtooth
+#
+# Each pattern writes adv-<pattern>.rep. The traces are balanced (every
+# block is freed at the end), so no -bal version is needed.
+#
+# Block sizes follow mm.c: a payload of p bytes becomes a block of
+# round8(p + 8), at least 24. @group_max is the upper bound of each class
+# in size_to_group(); keep the two in sync when the classes change.
+
+@group_max = (32, 48, 64, 96, 128, 192, 256, 384, 512, 768, 1024,
+              1536, 2048, 4096, 8192);
+
+%patterns = (
+    coalesce => \&gen_coalesce,
+    boundary => \&gen_boundary,
+    sawtooth => \&gen_sawtooth,
+);
+
+@todo = @ARGV ? @ARGV : sort keys %patterns;
+foreach $name (@todo) {
+    die "Unknown pattern $name\n" unless $patterns{$name};
+    @trace = ();
+    %live = ();
+    $next_id = 0;
+    $total_block_size = 0;
+    $patterns{$name}->();
+    free_all();
+    write_trace("adv-$name.rep");
+}
+
+# payload size whose block is exactly $blk bytes
+sub payload { return $_[0] - 8; }
+
+sub alloc {
+    my ($size) = @_;
+    my $id = $next_id++;
+    push @trace, "a $id $size";
+    $live{$id} = 1;
+    $total_block_size += $size;
+    return $id;
+}
+
+sub free {
+    my ($id) = @_;
+    push @trace, "f $id";
+    delete $live{$id};
+}
+
+sub free_all {
+    foreach $id (sort { $a <=> $b } keys %live) {
+        free($id);
+    }
+}
+
+sub write_trace {
+    my ($out_filename) = @_;
+    my $suggested_heap_size = $total_block_size + 100;
+    my $num_ops = scalar @trace;
+
+    open OUTFILE, ">$out_filename" or die "Cannot create $out_filename\n";
+    print OUTFILE "$suggested_heap_size\n";
+    print OUTFILE "$next_id\n";
+    print OUTFILE "$num_ops\n";
+    print OUTFILE "1\n";
+    foreach $op (@trace) {
+        print OUTFILE "$op\n";
+    }
+    close OUTFILE;
+}
+
+# coalesce: alternating lifetimes. Every round allocates short- and
+# long-lived blocks alternately and frees the short ones, so each hole is
+# pinned between two live blocks and can never merge. The next round asks
+# for a block one alignment unit larger than the holes, so none of them
+# fits and the heap has to grow while the live set barely does.
+sub gen_coalesce {
+    my $num_rounds = 40;
+    my $num_pairs = 100;
+    my $blk = 64;
+
+    for ($r = 0; $r < $num_rounds; $r += 1) {
+        my @short;
+        for ($i = 0; $i < $num_pairs; $i += 1) {
+            push @short, alloc(payload($blk));
+            alloc(payload(24));
+        }
+        foreach $id (@short) {
+            free($id);
+        }
+        $blk += 8;
+    }
+}
+
+# boundary: for every class boundary B, leave pinned free blocks of size B
+# (the top of class g) and then request blocks of size B + 8 (the bottom
+# of class g + 1). The holes sit in the list just below the one searched,
+# so they are never candidates, and the B + 8 requests find nothing in
+# their own class either. The B + 8 blocks die before the next boundary;
+# only the pins and the holes between them stay behind.
+sub gen_boundary {
+    my $bytes_per_class = 65536;
+
+    foreach $bound (@group_max) {
+        my $n = int($bytes_per_class / $bound);
+        my (@holes, @big);
+        for ($i = 0; $i < $n; $i += 1) {
+            push @holes, alloc(payload($bound));
+            alloc(payload(24));
+        }
+        foreach $id (@holes) {
+            free($id);
+        }
+        for ($i = 0; $i < $n; $i += 1) {
+            push @big, alloc(payload($bound + 8));
+        }
+        foreach $id (@big) {
+            free($id);
+        }
+    }
+}
+
+# sawtooth: each tooth allocates a run of blocks, keeps every fourth one
+# alive and frees the rest, leaving holes of three blocks. The next tooth
+# uses blocks larger than those holes, so it is served from the wilderness
+# and the heap rises in steps; the last block of every tooth is a pin, so
+# the holes never merge into the free tail either. After the peak the
+# pins are freed and the climb starts again from small sizes.
+sub gen_sawtooth {
+    my $num_cycles = 3;
+    my $run = 128;
+
+    for ($c = 0; $c < $num_cycles; $c += 1) {
+        my (@pins, @held);
+        my $blk = 32;
+        while ($blk <= 4096) {
+            for ($i = 0; $i < $run; $i += 1) {
+                my $id = alloc(payload($blk));
+                if ($i % 4 == 3) {
+                    push @pins, $id;
+                } else {
+                    push @held, $id;
+                }
+            }
+            while (@held) {
+                free(shift @held);
+            }
+            $blk = 3 * $blk + 8;
+            $blk = ($blk + 7) & ~7;
+        }
+        foreach $id (@pins) {
+            free($id);
+        }
+    }
+}
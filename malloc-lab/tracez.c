@@ -0,0 +1,412 @@
+/*
+ * tracez.c - compressed trace container: op record planes and the LZ codec
+ *
+ * 코덱은 LZ4 블록 형식을 단순화한 것이다: 시퀀스마다 토큰 한 바이트(상위 4비트
+ * 리터럴 길이, 하위 4비트 매치 길이 - 4, 15면 뒤에 255 단위로 이어짐), 리터럴,
+ * 16비트 오프셋. 마지막 시퀀스는 리터럴만 있다. 압축은 4바이트 해시 하나로 찾는
+ * greedy 방식이다.
+ *
+ * op는 varint가 아니라 바이트 평면으로 둔다. varint는 op마다 길이를 알아야 다음
+ * op 위치가 나오므로 풀기가 지연 시간에 묶이고 (무작위 trace에서 op당 20ns), 평면은
+ * 모든 op가 같은 위치 계산이라 분기 없이 독립적으로 풀린다. 차분의 상위 바이트
+ * 평면은 거의 0이므로 LZ가 긴 매치로 접는다.
+ */
+#include <stdlib.h>
+#include <string.h>
+
+#include "tracez.h"
+
+#define MIN_MATCH   4
+#define HASH_BITS   13
+#define MAX_OFFSET  65535
+#define PLANES      9                  /* bytes per op: type, 4 id, 4 size */
+#define MIN(x, y)   ((x) < (y) ? (x) : (y))
+
+/*********************
+ * Byte helpers
+ *********************/
+
+static uint32_t read32(const unsigned char *p)
+{
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static void put_le32(unsigned char *p, uint32_t v)
+{
+    p[0] = v; p[1] = v >> 8; p[2] = v >> 16; p[3] = v >> 24;
+}
+
+static uint32_t get_le32(const unsigned char *p)
+{
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint32_t zigzag(uint32_t delta)
+{
+    return (delta << 1) ^ (uint32_t)((int32_t)delta >> 31);
+}
+
+static uint32_t unzigzag(uint32_t v)
+{
+    return (v >> 1) ^ -(v & 1);
+}
+
+/*********************
+ * LZ codec
+ *********************/
+
+static unsigned char *put_length(unsigned char *p, size_t n)
+{
+    for (; n >= 255; n -= 255)
+        *p++ = 255;
+    *p++ = (unsigned char)n;
+    return p;
+}
+
+static unsigned char *put_sequence(unsigned char *op, const unsigned char *lit,
+                                   size_t nlit, size_t offset, size_t mlen)
+{
+    unsigned char *token = op++;
+
+    *token = (unsigned char)((nlit < 15 ? nlit : 15) << 4);
+    if (nlit >= 15)
+        op = put_length(op, nlit - 15);
+    memcpy(op, lit, nlit);
+    op += nlit;
+    if (mlen == 0)
+        return op;                     /* last sequence: literals only */
+
+    *op++ = (unsigned char)offset;
+    *op++ = (unsigned char)(offset >> 8);
+    mlen -= MIN_MATCH;
+    *token |= (unsigned char)(mlen < 15 ? mlen : 15);
+    if (mlen >= 15)
+        op = put_length(op, mlen - 15);
+    return op;
+}
+
+/*
+ * tz_compress - compress len bytes (at most TZ_BLOCK) into dst, which must
+ *     hold TZ_COMPRESS_BOUND(len) bytes; returns the compressed length
+ */
+size_t tz_compress(const unsigned char *src, size_t len, unsigned char *dst)
+{
+    uint32_t table[1 << HASH_BITS];    /* hash -> position + 1 */
+    size_t ip = 0, anchor = 0;
+    unsigned char *op = dst;
+
+    memset(table, 0, sizeof(table));
+    while (len >= MIN_MATCH + 1 && ip < len - MIN_MATCH) {
+        uint32_t seq = read32(src + ip);
+        uint32_t h = (seq * 2654435761u) >> (32 - HASH_BITS);
+        size_t ref = table[h];
+
+        table[h] = (uint32_t)ip + 1;
+        if (ref == 0 || ip - (ref - 1) > MAX_OFFSET || read32(src + ref - 1) != seq) {
+            ip++;
+            continue;
+        }
+        ref--;
+        size_t mlen = MIN_MATCH;
+        while (ip + mlen < len && src[ref + mlen] == src[ip + mlen])
+            mlen++;
+        op = put_sequence(op, src + anchor, ip - anchor, ip - ref, mlen);
+        ip += mlen;
+        anchor = ip;
+    }
+    op = put_sequence(op, src + anchor, len - anchor, 0, 0);
+    return (size_t)(op - dst);
+}
+
+/*
+ * tz_decompress - expand src into dst (cap bytes); returns the expanded
+ *     length, or -1 if the input is corrupt or does not fit
+ */
+long tz_decompress(const unsigned char *src, size_t len,
+                   unsigned char *dst, size_t cap)
+{
+    const unsigned char *ip = src, *iend = src + len;
+    unsigned char *op = dst, *oend = dst + cap;
+
+    while (ip < iend) {
+        unsigned token = *ip++;
+        size_t nlit = token >> 4, mlen = token & 15, offset;
+
+        if (nlit == 15) {
+            unsigned char b;
+            do {
+                if (ip >= iend) return -1;
+                nlit += b = *ip++;
+            } while (b == 255);
+        }
+        if ((size_t)(iend - ip) < nlit || (size_t)(oend - op) < nlit)
+            return -1;
+        if (nlit <= 16 && iend - ip >= 16 && oend - op >= 16)
+            memcpy(op, ip, 16);        /* 짧은 리터럴: 고정 길이 복사 (뒤는 덮어씀) */
+        else
+            memcpy(op, ip, nlit);
+        op += nlit;
+        ip += nlit;
+        if (ip == iend)
+            break;                     /* last sequence */
+
+        if (iend - ip < 2) return -1;
+        offset = ip[0] | (ip[1] << 8);
+        ip += 2;
+        if (mlen == 15) {
+            unsigned char b;
+            do {
+                if (ip >= iend) return -1;
+                mlen += b = *ip++;
+            } while (b == 255);
+        }
+        mlen += MIN_MATCH;
+        if (offset == 0 || offset > (size_t)(op - dst) || (size_t)(oend - op) < mlen)
+            return -1;
+
+        const unsigned char *ref = op - offset;
+        if (offset >= 16 && (size_t)(oend - op) >= mlen + 16) {
+            for (size_t i = 0; i < mlen; i += 16)
+                memcpy(op + i, ref + i, 16);
+            op += mlen;
+        } else {
+            /* 겹치는 매치는 주기 offset의 반복: 이미 쓴 부분을 두 배씩 늘려 복사 */
+            while (mlen > 0) {
+                size_t c = MIN((size_t)(op - ref), mlen);
+                memcpy(op, ref, c);
+                op += c;
+                mlen -= c;
+            }
+        }
+    }
+    return (long)(op - dst);
+}
+
+/*********************
+ * Op planes
+ *********************/
+
+/*
+ * 블록의 원본은 n개 op의 평면 9개: type[n], zigzag(id 차분)의 바이트 0..3 평면,
+ * zigzag(size 차분)의 바이트 0..3 평면. free의 size 차분은 0이다 (직전 size 유지).
+ * 쓰는 동안에는 평면 간격이 TZ_BLOCK_OPS이고, 내보낼 때 n 간격으로 당긴다.
+ */
+static void put_op(unsigned char *raw, size_t stride, uint32_t i,
+                   uint32_t type, uint32_t zid, uint32_t zsize)
+{
+    raw[i] = (unsigned char)type;
+    for (int b = 0; b < 4; b++) {
+        raw[(1 + b) * stride + i] = (unsigned char)(zid >> (8 * b));
+        raw[(5 + b) * stride + i] = (unsigned char)(zsize >> (8 * b));
+    }
+}
+
+/* Decode ops [from, to) of a block of n ops; returns -1 on a bad type */
+static int get_ops(const unsigned char *raw, uint32_t n, uint32_t from, uint32_t to,
+                   tz_op_t *op, uint32_t *id, uint32_t *size)
+{
+    const unsigned char *t = raw, *i0 = raw + n, *s0 = raw + 5 * n;
+    uint32_t bad = 0;
+
+    for (uint32_t i = from; i < to; i++, op++) {
+        uint32_t zid = i0[i] | i0[n + i] << 8 | i0[2 * n + i] << 16 |
+                       (uint32_t)i0[3 * n + i] << 24;
+        uint32_t zs = s0[i] | s0[n + i] << 8 | s0[2 * n + i] << 16 |
+                      (uint32_t)s0[3 * n + i] << 24;
+        uint32_t type = t[i];
+
+        *id += unzigzag(zid);
+        *size += unzigzag(zs);
+        bad |= type > TZ_REALLOC;
+        op->type = type;
+        op->id = *id;
+        op->size = (type != TZ_FREE) ? *size : 0;
+    }
+    return bad ? -1 : 0;
+}
+
+/*********************
+ * Writer
+ *********************/
+
+static int flush_block(tz_writer_t *w)
+{
+    unsigned char hdr[12];
+    size_t len = (size_t)PLANES * w->nops, clen;
+    const unsigned char *payload;
+
+    if (w->nops == 0)
+        return 0;
+    for (int k = 1; k < PLANES; k++)
+        memmove(w->raw + (size_t)k * w->nops, w->raw + (size_t)k * TZ_BLOCK_OPS, w->nops);
+    clen = tz_compress(w->raw, len, w->comp);
+    payload = w->comp;
+    if (clen >= len) {                 /* 압축이 안 되는 블록은 그대로 */
+        clen = len;
+        payload = w->raw;
+    }
+    put_le32(hdr, (uint32_t)len);
+    put_le32(hdr + 4, (uint32_t)clen);
+    put_le32(hdr + 8, w->nops);
+    if (fwrite(hdr, 1, sizeof(hdr), w->fp) != sizeof(hdr) ||
+        fwrite(payload, 1, clen, w->fp) != clen)
+        return -1;
+    w->raw_total += len;
+    w->comp_total += clen + sizeof(hdr);
+    w->nops = 0;
+    w->prev_id = w->prev_size = 0;
+    return 0;
+}
+
+/*
+ * tz_create - write the file header and set up the block buffers;
+ *     returns 0, or -1 on a write or allocation failure
+ */
+int tz_create(tz_writer_t *w, FILE *fp, const tz_header_t *h)
+{
+    unsigned char hdr[24];
+
+    memset(w, 0, sizeof(*w));
+    w->fp = fp;
+    if ((w->raw = malloc(TZ_BLOCK)) == NULL ||
+        (w->comp = malloc(TZ_COMPRESS_BOUND(TZ_BLOCK))) == NULL) {
+        free(w->raw);
+        return -1;
+    }
+    memcpy(hdr, TZ_MAGIC, 4);
+    put_le32(hdr + 4, TZ_VERSION);
+    put_le32(hdr + 8, (uint32_t)h->sugg_heapsize);
+    put_le32(hdr + 12, (uint32_t)h->num_ids);
+    put_le32(hdr + 16, (uint32_t)h->num_ops);
+    put_le32(hdr + 20, (uint32_t)h->weight);
+    if (fwrite(hdr, 1, sizeof(hdr), fp) != sizeof(hdr))
+        return -1;
+    w->comp_total = sizeof(hdr);
+    return 0;
+}
+
+int tz_write(tz_writer_t *w, const tz_op_t *op)
+{
+    uint32_t zsize = 0;
+
+    if (w->nops == TZ_BLOCK_OPS && flush_block(w) != 0)
+        return -1;
+    if (op->type != TZ_FREE) {
+        zsize = zigzag(op->size - w->prev_size);
+        w->prev_size = op->size;
+    }
+    put_op(w->raw, TZ_BLOCK_OPS, w->nops++, op->type, zigzag(op->id - w->prev_id), zsize);
+    w->prev_id = op->id;
+    return 0;
+}
+
+/* tz_finish - flush the last block, write the end marker, free the buffers */
+int tz_finish(tz_writer_t *w)
+{
+    static const unsigned char end[12];
+    int rc = flush_block(w);
+
+    if (rc == 0 && fwrite(end, 1, sizeof(end), w->fp) != sizeof(end))
+        rc = -1;
+    w->comp_total += sizeof(end);
+    free(w->raw);
+    free(w->comp);
+    w->raw = w->comp = NULL;
+    return rc;
+}
+
+/*********************
+ * Reader
+ *********************/
+
+/*
+ * tz_open - check the file header of fp (positioned at its start) and set
+ *     up the block buffers; returns 0, or -1 if fp is not a .repz file
+ */
+int tz_open(tz_reader_t *r, FILE *fp, tz_header_t *h)
+{
+    unsigned char hdr[24];
+
+    memset(r, 0, sizeof(*r));
+    if (fread(hdr, 1, sizeof(hdr), fp) != sizeof(hdr) ||
+        memcmp(hdr, TZ_MAGIC, 4) != 0 || get_le32(hdr + 4) != TZ_VERSION)
+        return -1;
+    h->sugg_heapsize = (int)get_le32(hdr + 8);
+    h->num_ids = (int)get_le32(hdr + 12);
+    h->num_ops = (int)get_le32(hdr + 16);
+    h->weight = (int)get_le32(hdr + 20);
+    if ((r->raw = malloc(TZ_BLOCK)) == NULL ||
+        (r->comp = malloc(TZ_COMPRESS_BOUND(TZ_BLOCK))) == NULL) {
+        free(r->raw);
+        return -1;
+    }
+    r->fp = fp;
+    return 0;
+}
+
+/* Read and expand the next block; 1 = loaded, 0 = end of file, -1 = corrupt */
+static int next_block(tz_reader_t *r)
+{
+    unsigned char hdr[12];
+    uint32_t rlen, clen, nops;
+
+    if (fread(hdr, 1, sizeof(hdr), r->fp) != sizeof(hdr))
+        return -1;
+    rlen = get_le32(hdr);
+    clen = get_le32(hdr + 4);
+    nops = get_le32(hdr + 8);
+    if (rlen == 0) {
+        r->done = 1;
+        return 0;
+    }
+    if (nops == 0 || nops > TZ_BLOCK_OPS || rlen != PLANES * nops || clen > rlen)
+        return -1;
+    if (clen == rlen) {
+        if (fread(r->raw, 1, rlen, r->fp) != rlen)
+            return -1;
+    } else if (fread(r->comp, 1, clen, r->fp) != clen ||
+               tz_decompress(r->comp, clen, r->raw, TZ_BLOCK) != (long)rlen) {
+        return -1;
+    }
+    r->nops = nops;
+    r->next = 0;
+    r->prev_id = r->prev_size = 0;
+    return 1;
+}
+
+/*
+ * tz_read - decode up to max ops into ops[]; returns the number decoded
+ *     (0 at the end of the trace), or -1 if the file is corrupt
+ */
+int tz_read(tz_reader_t *r, tz_op_t *ops, int max)
+{
+    int n = 0;
+
+    while (n < max) {
+        if (r->next == r->nops) {
+            int rc = r->done ? 0 : next_block(r);
+            if (rc <= 0) {
+                if (rc < 0) return -1;
+                break;
+            }
+        }
+        uint32_t k = r->nops - r->next;
+        if (k > (uint32_t)(max - n))
+            k = max - n;
+        if (get_ops(r->raw, r->nops, r->next, r->next + k, ops + n,
+                    &r->prev_id, &r->prev_size) != 0)
+            return -1;
+        r->next += k;
+        n += k;
+    }
+    return n;
+}
+
+void tz_close(tz_reader_t *r)
+{
+    free(r->raw);
+    free(r->comp);
+    r->raw = r->comp = NULL;
+}
@@ -0,0 +1,79 @@
+#ifndef __TRACEZ_H_
+#define __TRACEZ_H_
+
+/*
+ * tracez.h - compressed trace container (.repz)
+ *
+ * .rep 텍스트 trace를 블록 단위로 압축해 담는 형식. 블록마다 op를 바이트 평면으로
+ * 펼치고 (id와 크기는 직전 op와의 차분) 자체 LZ 코덱으로 압축한다. 블록마다 차분
+ * 상태를 새로 시작하므로 블록 하나만으로 풀 수 있다.
+ *
+ *   file  = "MMTZ" version sugg_heapsize num_ids num_ops weight  (u32 LE 각각)
+ *           block* end
+ *   block = raw_len comp_len nops (u32 LE) payload[comp_len]
+ *           raw_len == 9 * nops, comp_len == raw_len이면 payload는 압축하지 않은 그대로
+ *   end   = raw_len == 0 인 블록 헤더
+ *   raw   = type[nops] id0[nops] .. id3[nops] size0[nops] .. size3[nops]
+ *           type: 0 alloc, 1 free, 2 realloc
+ *           idK/sizeK: zigzag(값 - 직전 값)의 K번째 바이트 (free의 size 차분은 0)
+ *
+ * 읽는 쪽(tz_open, tz_read)은 블록 하나 크기의 버퍼 두 개로 스트리밍하므로,
+ * trace 전체를 메모리에 올리지 않고 op 배열로 바로 풀 수 있다.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+
+#define TZ_MAGIC      "MMTZ"
+#define TZ_VERSION    1
+#define TZ_BLOCK_OPS  7168             /* ops per block */
+#define TZ_BLOCK      (9 * TZ_BLOCK_OPS) /* raw bytes per block (LZ offsets are 16 bits) */
+
+enum { TZ_ALLOC, TZ_FREE, TZ_REALLOC };
+
+typedef struct {
+    int sugg_heapsize;
+    int num_ids;
+    int num_ops;
+    int weight;
+} tz_header_t;
+
+typedef struct {
+    uint32_t type;                     /* TZ_ALLOC, TZ_FREE or TZ_REALLOC */
+    uint32_t id;
+    uint32_t size;                     /* 0 for frees */
+} tz_op_t;
+
+/* Streaming writer */
+typedef struct {
+    FILE *fp;
+    unsigned char *raw, *comp;
+    uint32_t nops;                     /* ops in the current block */
+    uint32_t prev_id, prev_size;
+    uint64_t raw_total, comp_total;    /* for the caller's report */
+} tz_writer_t;
+
+int  tz_create(tz_writer_t *w, FILE *fp, const tz_header_t *h);
+int  tz_write(tz_writer_t *w, const tz_op_t *op);
+int  tz_finish(tz_writer_t *w);
+
+/* Streaming reader */
+typedef struct {
+    FILE *fp;
+    unsigned char *raw, *comp;
+    uint32_t nops, next;               /* ops in the current block, next to decode */
+    uint32_t prev_id, prev_size;
+    int done;
+} tz_reader_t;
+
+int  tz_open(tz_reader_t *r, FILE *fp, tz_header_t *h);
+int  tz_read(tz_reader_t *r, tz_op_t *ops, int max);
+void tz_close(tz_reader_t *r);
+
+/* The block codec on its own */
+size_t tz_compress(const unsigned char *src, size_t len, unsigned char *dst);
+long   tz_decompress(const unsigned char *src, size_t len,
+                     unsigned char *dst, size_t cap);
+#define TZ_COMPRESS_BOUND(n) ((n) + (n) / 255 + 16)
+
+#endif /* __TRACEZ_H_ */